@@ -1,6 +1,10 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <fstream>
+#include <sstream>
 #include "Interactome.hpp"
+#include "phegeni_reader.hpp"
+#include "create_modules.hpp"
 
 class ModuleCreatorFixture : public ::testing::Test {
 
@@ -18,18 +22,186 @@ protected:
     const std::string output_path;
 };
 
-TEST(CreateModulesSuite, CreateGeneModuleTest){
-    ASSERT_TRUE(true);
+// Three genes, their proteins and proteoforms, connected at each level: G1-G2, P1-P2, PF1-PF2
+class LevelsFixture : public ::testing::Test {
+
+protected:
+    virtual void SetUp() override {
+        interactome = Interactome({{0, 1}, {3, 4}, {6, 7}, {2, 8}});
+        interactome.addNode(5);
+        interactome.finalize();
+        std::stringstream names("0 G1 1 G2 2 G3 3 P1 4 P2 5 P3 6 PF1 7 PF2 8 PF3");
+        interactome.readNodeNames(names);
+        std::stringstream ranges("0 2\n3 5\n6 8");
+        interactome.readTypeRanges(ranges);
+        mappings.genes_to_proteins = {{0, {3}}, {1, {4}}, {2, {5}}};
+        mappings.proteins_to_proteoforms = {{3, {6}}, {4, {7}}, {5, {8}}};
+
+        file_phegeni = ::testing::TempDir() + "phegeni_levels.tsv";
+        std::ofstream f(file_phegeni);
+        f << "header\n";
+        f << "1\tAsthma\t1\tintron\tG1\t11\tG2\t12\t1\t100\t1E-8\n";
+        f << "2\tObesity\t2\tintron\tG3\t13\tUNKNOWN\t0\t2\t200\t2E-9\n";
+    }
+
+    Interactome interactome;
+    LevelMappings mappings;
+    std::string file_phegeni;
+};
+
+TEST_F(LevelsFixture, CreateGeneModuleTest) {
+    auto modules = createGeneModules(file_phegeni, interactome);
+
+    ASSERT_EQ(2, modules.size());
+    EXPECT_THAT(modules.at("Asthma").getVertices(), ::testing::ElementsAre(0, 1));
+    EXPECT_THAT(modules.at("Obesity").getVertices(), ::testing::ElementsAre(2));
+    EXPECT_TRUE(modules.at("Asthma").accessioned_entity_vertices.contains(1));
+    EXPECT_EQ(3, modules.at("Asthma").accessioned_entity_vertices.universeSize());
+}
+
+TEST_F(LevelsFixture, CreateProteinModuleTest) {
+    auto modules = createModules(file_phegeni, interactome, mappings, 2);
+    Module &protein_module = modules[proteins].at("Asthma");
+
+    EXPECT_EQ(proteins, protein_module.getLevel());
+    EXPECT_THAT(protein_module.getVertices(), ::testing::ElementsAre(3, 4));
+    EXPECT_THAT(protein_module.getNeighbors(3), ::testing::ElementsAre(4));
+    EXPECT_TRUE(protein_module.accessioned_entity_vertices.contains(0));
+}
+
+// Small molecules S1 and S2 interact with G1 and with each other, S3 only with S2, so it is not a member
+TEST(CreateGeneModulesTest, InducesSmallMoleculeInteractionsTest) {
+    Interactome interactome({{0, 4}, {0, 5}, {4, 5}, {5, 6}, {0, 1}});
+    interactome.addNode(2);
+    interactome.addNode(3);
+    interactome.finalize();
+    std::stringstream names("0 G1 1 G2 2 P1 3 PF1 4 S1 5 S2 6 S3");
+    interactome.readNodeNames(names);
+    std::stringstream ranges("0 1\n2 2\n3 3\n4 6");
+    interactome.readTypeRanges(ranges);
+    std::string file_phegeni = ::testing::TempDir() + "phegeni_small_molecules.tsv";
+    std::ofstream(file_phegeni) << "header\n" << "1\tAsthma\t1\tintron\tG1\t11\tUNKNOWN\t0\t1\t100\t1E-8\n";
+
+    auto modules = createGeneModules(file_phegeni, interactome, 2);
+    Module &module = modules.at("Asthma");
+    EXPECT_THAT(module.getVertices(), ::testing::ElementsAre(0, 4, 5));
+    EXPECT_THAT(module.getNeighbors(4), ::testing::ElementsAre(0, 5));
+    EXPECT_THAT(module.getNeighbors(5), ::testing::ElementsAre(0, 4));
+}
+
+// Protein 4 has two proteoforms, protein 5 none
+TEST_F(LevelsFixture, LevelLinksProjectionTest) {
+    LevelLinks links(interactome, proteins, proteoforms, {{3, {6}}, {4, {8, 7}}, {5, {}}, {0, {6}}});
+
+    EXPECT_EQ(3, links.numParents());
+    EXPECT_EQ(4, links.getParent(8));
+    auto children_of_4 = links.getChildren(4);
+    EXPECT_THAT(std::vector<int>(children_of_4.begin(), children_of_4.end()), ::testing::ElementsAre(7, 8));
+    EXPECT_TRUE(links.getChildren(5).empty());
+
+    base::dynamic_bitset<> protein_set(3);
+    protein_set[1].set();
+    base::dynamic_bitset<> proteoform_set = links.expand(protein_set);
+    EXPECT_FALSE(proteoform_set[0]);
+    EXPECT_TRUE(proteoform_set[1] && proteoform_set[2]);
+
+    base::dynamic_bitset<> lifted = links.lift(proteoform_set);
+    EXPECT_EQ(1, lifted.count());
+    EXPECT_TRUE(lifted[1]);
+    EXPECT_THROW((void) links.lift(base::dynamic_bitset<>(4)), std::invalid_argument);
 }
 
-TEST(CreateModulesSuite, CreateProteinModuleTest){
-    ASSERT_TRUE(true);
+// More than 64 sets, so the last batch is partial
+TEST_F(LevelsFixture, BatchedProjectionMatchesSingleProjectionTest) {
+    LevelLinks links(interactome, proteins, proteoforms, {{3, {6, 7}}, {4, {7}}, {5, {8}}});
+    vb sets;
+    for (int I = 0; I < 70; I++) {
+        sets.emplace_back(3);
+        for (int bit = 0; bit < 3; bit++)
+            if ((I >> bit) & 1)
+                sets.back()[bit].set();
+    }
+
+    vb expanded = links.expand(sets, 2);
+    vb lifted = links.lift(expanded, 2);
+    ASSERT_EQ(70, expanded.size());
+    for (int I = 0; I < 70; I++) {
+        EXPECT_EQ(links.expand(sets[I]), expanded[I]);
+        EXPECT_EQ(links.lift(expanded[I]), lifted[I]);
+    }
+    EXPECT_TRUE(expanded[1][0] && expanded[1][1] && !expanded[1][2]);
+
+    std::vector<HybridSet> hybrid_sets(sets.begin(), sets.end());
+    vb hybrid_expanded = links.expand(hybrid_sets, 2);
+    for (int I = 0; I < 70; I++) {
+        EXPECT_EQ(expanded[I], hybrid_expanded[I]);
+        EXPECT_EQ(expanded[I], links.expand(hybrid_sets[I]));
+    }
 }
 
-TEST(CreateModulesSuite, CreateProetoformModuleTest){
-    ASSERT_TRUE(true);
+TEST_F(LevelsFixture, CreateProetoformModuleTest) {
+    auto modules = createModules(file_phegeni, interactome, mappings, 2);
+
+    ASSERT_EQ(3, modules.size());
+    EXPECT_THAT(modules[proteoforms].at("Asthma").getVertices(), ::testing::ElementsAre(6, 7));
+    EXPECT_THAT(modules[proteoforms].at("Asthma").getNeighbors(7), ::testing::ElementsAre(6));
+    EXPECT_THAT(modules[proteoforms].at("Obesity").getVertices(), ::testing::ElementsAre(8));
+    EXPECT_THAT(modules[genes].at("Asthma").getNeighbors(0), ::testing::ElementsAre(1));
 }
 
-TEST(CreateModulesSuite, SaveModuleTest){
-    ASSERT_TRUE(true);
-}
\ No newline at end of file
+TEST_F(LevelsFixture, SaveModuleTest) {
+    auto modules = createModules(file_phegeni, interactome, mappings, 2);
+    saveModules(modules[proteins], ::testing::TempDir());
+
+    auto read_file = [](const std::string &file_name) {
+        std::ifstream f(file_name);
+        return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    };
+    EXPECT_EQ("3\t4\n4\t3\n", read_file(::testing::TempDir() + "Asthma_proteins.tsv"));
+    EXPECT_EQ("5\t5\n", read_file(::testing::TempDir() + "Obesity_proteins.tsv"));
+}
+class PheGenIReaderFixture : public ::testing::Test {
+
+protected:
+    virtual void SetUp() override {
+        file_phegeni = ::testing::TempDir() + "phegeni.tsv";
+        std::ofstream f(file_phegeni);
+        f << "#\tTrait\tSNP rs\tContext\tGene\tGene ID\tGene 2\tGene ID 2\tChromosome\tLocation\tP-Value\tSource\t"
+             "PubMed\tAnalysis ID\tStudy ID\tStudy Name\n";
+        f << "1\tAsthma\t1\tintron\tGENE1\t11\tGENE2\t12\t1\t100\t1E-8\tNHGRI\t1\t1\t1\tStudy\n";
+        f << "2\tObesity\t2\tintron\tGENE3\t13\tGENE1\t11\t2\t200\t2E-9\tNHGRI\t2\t2\t2\tStudy\r\n";
+        f << "3\tAsthma\t3\tintron\tGENE4\t14\t\t\t3\t300\t3E-10\tNHGRI\t3\t3\t3\tStudy";
+    }
+
+    std::string file_phegeni;
+};
+
+// PheGenI reader: splits the rows and interns the traits in order of appearance
+TEST_F(PheGenIReaderFixture, ReadsAssociationsTest) {
+    PheGenIReader reader(file_phegeni);
+    std::vector<int> traits;
+    std::vector<std::string> genes, genes_2, p_values;
+
+    reader.forEachAssociation([&](const PheGenIAssociation &association) {
+        traits.push_back(association.trait);
+        genes.emplace_back(association.gene);
+        genes_2.emplace_back(association.gene_2);
+        p_values.emplace_back(association.p_value);
+    });
+
+    EXPECT_THAT(traits, ::testing::ElementsAre(0, 1, 0));
+    EXPECT_THAT(genes, ::testing::ElementsAre("GENE1", "GENE3", "GENE4"));
+    EXPECT_THAT(genes_2, ::testing::ElementsAre("GENE2", "GENE1", ""));
+    EXPECT_THAT(p_values, ::testing::ElementsAre("1E-8", "2E-9", "3E-10"));
+    EXPECT_EQ(2, reader.numTraits());
+    EXPECT_EQ("Obesity", reader.getTraitName(1));
+}
+
+// PheGenI reader: rows without the p-value column are rejected
+TEST(CreateModulesSuite, PheGenIReaderMissingColumnsThrowsException) {
+    std::string file_phegeni = ::testing::TempDir() + "phegeni_short.tsv";
+    std::ofstream(file_phegeni) << "header\n1\tAsthma\t1\n";
+    PheGenIReader reader(file_phegeni);
+
+    EXPECT_THROW(reader.forEachAssociation([](const PheGenIAssociation &) {}), std::runtime_error);
+}
@@ -1,7 +1,13 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
+#include <cstddef>
 #include <vector>
 #include <Interactome.hpp>
+#include <distance_matrix.hpp>
+#include <multi_source_bfs.hpp>
+#include <numeric>
+#include <queue>
+#include <random>
 #include <tuple>
 
 using ::testing::UnorderedElementsAreArray;
@@ -59,7 +65,8 @@ TEST_F(InteractomeFixture, CreateNetworkFromInteractionList) {
 }
 
 TEST_F(InteractomeFixture, GetAllInteractorsTest) {
-    std::vector<int> neighbors = interactome.getInteractors(2);
+    auto interactors = interactome.getInteractors(2);
+    std::vector<int> neighbors(interactors.begin(), interactors.end());
 
     ASSERT_EQ(neighbors.size(), 2);
     ASSERT_THAT(neighbors, UnorderedElementsAreArray({1, 3}));
@@ -67,10 +74,47 @@ TEST_F(InteractomeFixture, GetAllInteractorsTest) {
 }
 
 TEST_F(InteractomeFixture, GetAllInteractorsWithNonexistentNodeTest) {
-    std::vector<int> neighbors;
+    std::span<const int> neighbors;
     ASSERT_THROW(neighbors = interactome.getInteractors(7), std::out_of_range);
 }
 
+TEST_F(InteractomeFixture, InteractorsAreSortedAndUniqueTest) {
+    std::vector<std::pair<int, int>> interactions = {
+            std::make_pair(2, 5),
+            std::make_pair(3, 2),
+            std::make_pair(1, 2)
+    };
+    interactome.addInteractions(interactions);
+    interactome.finalize();
+
+    auto interactors = interactome.getInteractors(2);
+    ASSERT_THAT(std::vector<int>(interactors.begin(), interactors.end()), ::testing::ElementsAre(1, 3, 5));
+}
+
+TEST_F(InteractomeFixture, AddedNodeHasNoInteractorsTest) {
+    interactome.addNode(7);
+    interactome.finalize();
+    ASSERT_TRUE(interactome.getInteractors(7).empty());
+    ASSERT_EQ(interactome.getInteractors(5).size(), 1);
+}
+
+// Staged nodes and interactions are only readable after finalize(), which builds the adjacency once
+TEST_F(InteractomeFixture, ReadingPendingChangesThrowsExceptionTest) {
+    interactome.addNode(7);
+    interactome.addInteractions({{5, 9}});
+    interactome.addInteractions({{7, 9}});
+    ASSERT_TRUE(interactome.hasPendingChanges());
+    ASSERT_TRUE(interactome.hasNode(9));
+    ASSERT_THROW((void) interactome.getInteractors(5), std::logic_error);
+    ASSERT_THROW((void) interactome.getAdjacency(), std::logic_error);
+
+    interactome.finalize();
+    ASSERT_FALSE(interactome.hasPendingChanges());
+    auto interactors = interactome.getInteractors(9);
+    ASSERT_THAT(std::vector<int>(interactors.begin(), interactors.end()), ::testing::ElementsAre(5, 7));
+    ASSERT_EQ(interactome.getAdjacency().numVertices(), 10);
+}
+
 TEST_F(InteractomeFixture, CheckIfNodeExistsByIndexTest) {
     ASSERT_TRUE(interactome.hasNode(1));
     ASSERT_FALSE(interactome.hasNode(7));
@@ -163,9 +207,349 @@ TEST_F(InteractomeFixture, CheckIfNodeExistsByNameTest) {
 }
 
 TEST_F(InteractomeFixture, ReadTypesTest){
-    std::string ranges = "";
+    std::string ranges = "1 2\n3 3\n4 4\n5 5";
     std::istringstream ss(ranges);
     interactome.readTypeRanges(ss);
 
-    ASSERT_EQ(interactome.getGenesStart(0));
-}
\ No newline at end of file
+    ASSERT_EQ(1, interactome.getStartIndexGenes());
+    ASSERT_EQ(2, interactome.getEndIndexGenes());
+    ASSERT_EQ(4, interactome.getStartIndexProteoforms());
+    ASSERT_EQ(4, interactome.getNumLevels());
+}
+
+TEST_F(InteractomeFixture, GetTypeTest) {
+    std::istringstream ss("1 2\n3 3\n4 4\n5 5");
+    interactome.readTypeRanges(ss);
+
+    EXPECT_EQ(genes, interactome.get_type(2));
+    EXPECT_EQ(proteins, interactome.get_type("C"));
+    EXPECT_TRUE(interactome.isProteoform(4));
+    EXPECT_TRUE(interactome.isSimpleEntity(5));
+    EXPECT_FALSE(interactome.isGene(3));
+    EXPECT_THROW((void) interactome.get_type(0), std::out_of_range);
+}
+
+TEST_F(InteractomeFixture, OverlappingTypeRangesThrowsExceptionTest) {
+    std::istringstream ss("1 3\n3 4");
+    EXPECT_THROW(interactome.readTypeRanges(ss), std::invalid_argument);
+}
+
+// Neighbors of one level are a slice of the sorted neighbors
+TEST_F(InteractomeFixture, GetInteractorsOfLevelTest) {
+    std::istringstream ss("1 2\n3 3\n4 4\n5 5");
+    interactome.readTypeRanges(ss);
+    interactome.addInteractions({{2, 5}, {2, 4}});
+    interactome.finalize();
+
+    auto genes_of_2 = interactome.getInteractors(2, genes);
+    EXPECT_THAT(std::vector<int>(genes_of_2.begin(), genes_of_2.end()), ::testing::ElementsAre(1));
+    auto proteins_of_2 = interactome.getProteinNeighbors(2);
+    EXPECT_THAT(std::vector<int>(proteins_of_2.begin(), proteins_of_2.end()), ::testing::ElementsAre(3));
+    auto simple_entities_of_2 = interactome.getSimpleEntityNeighbors(2);
+    EXPECT_THAT(std::vector<int>(simple_entities_of_2.begin(), simple_entities_of_2.end()), ::testing::ElementsAre(5));
+    EXPECT_TRUE(interactome.getProteoformNeighbors(1).empty());
+    EXPECT_EQ(interactome.getInteractors(2).data() + 3, simple_entities_of_2.data());
+}
+// Node 2 is outside all the levels, and the proteins level is empty
+TEST_F(InteractomeFixture, GetInteractorsOfLevelsWithGapsTest) {
+    std::istringstream ss("1 1\n3 2\n3 3\n4 5");
+    interactome.readTypeRanges(ss);
+    interactome.addInteractions({{2, 5}, {2, 4}});
+    interactome.finalize();
+
+    auto genes_of_2 = interactome.getInteractors(2, genes);
+    EXPECT_THAT(std::vector<int>(genes_of_2.begin(), genes_of_2.end()), ::testing::ElementsAre(1));
+    EXPECT_TRUE(interactome.getProteinNeighbors(2).empty());
+    auto proteoforms_of_2 = interactome.getProteoformNeighbors(2);
+    EXPECT_THAT(std::vector<int>(proteoforms_of_2.begin(), proteoforms_of_2.end()), ::testing::ElementsAre(3));
+    auto simple_entities_of_2 = interactome.getSimpleEntityNeighbors(2);
+    EXPECT_THAT(std::vector<int>(simple_entities_of_2.begin(), simple_entities_of_2.end()),
+                ::testing::ElementsAre(4, 5));
+    EXPECT_TRUE(interactome.getInteractors(1, genes).empty());
+    auto simple_entities_of_4 = interactome.getSimpleEntityNeighbors(4);
+    EXPECT_THAT(std::vector<int>(simple_entities_of_4.begin(), simple_entities_of_4.end()), ::testing::ElementsAre(5));
+}
+
+TEST_F(InteractomeFixture, SnapshotRoundTripTest) {
+    std::string file_snapshot = ::testing::TempDir() + "interactome.snapshot";
+    interactome.writeSnapshot(file_snapshot);
+
+    Interactome loaded{InteractomeSnapshot(file_snapshot)};
+    ASSERT_EQ(loaded.getNodeName(2), "B");
+    ASSERT_TRUE(loaded.hasNode("E"));
+    auto interactors = loaded.getInteractors(2);
+    ASSERT_THAT(std::vector<int>(interactors.begin(), interactors.end()), ::testing::ElementsAre(1, 3));
+}
+
+// Index gaps and nodes with the default name survive the round trip
+TEST(InteractomeSnapshotTest, SparseRoundTripTest) {
+    Interactome sparse({{3, 17}, {17, 20}});
+    sparse.addNode(25);
+    sparse.finalize();
+    std::string file_snapshot = ::testing::TempDir() + "sparse.snapshot";
+    sparse.writeSnapshot(file_snapshot);
+
+    Interactome loaded{InteractomeSnapshot(file_snapshot)};
+    EXPECT_EQ(loaded.getNodes(), sparse.getNodes());
+    for (int node = 0; node <= 26; node++)
+        EXPECT_EQ(loaded.hasNode(node), sparse.hasNode(node)) << node;
+    EXPECT_EQ(loaded.getNodeIndex("17"), sparse.getNodeIndex("17"));
+    EXPECT_FALSE(loaded.hasNode("17"));
+    EXPECT_EQ(loaded.getNodeName(17), "17");
+    auto interactors = loaded.getInteractors(17);
+    EXPECT_THAT(std::vector<int>(interactors.begin(), interactors.end()), ::testing::ElementsAre(3, 20));
+}
+
+TEST_F(InteractomeFixture, SnapshotRoundTripKeepsAbsentNodesTest) {
+    std::string file_snapshot = ::testing::TempDir() + "interactome_gaps.snapshot";
+    interactome.writeSnapshot(file_snapshot);
+
+    Interactome loaded{InteractomeSnapshot(file_snapshot)};
+    EXPECT_FALSE(loaded.hasNode(0));
+    EXPECT_THAT(loaded.getNodes(), UnorderedElementsAreArray({1, 2, 3, 4, 5}));
+    EXPECT_EQ(loaded.getNodeIndex("C"), 3);
+    EXPECT_EQ(loaded.getNodeIndex("0"), -1);
+}
+
+TEST_F(InteractomeFixture, SnapshotWithWrongChecksumThrowsExceptionTest) {
+    std::string file_snapshot = ::testing::TempDir() + "corrupted.snapshot";
+    interactome.writeSnapshot(file_snapshot);
+    {
+        std::fstream f(file_snapshot, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(-1, std::ios::end);
+        f.put('X');
+    }
+    ASSERT_THROW(InteractomeSnapshot{file_snapshot}, std::runtime_error);
+    ASSERT_NO_THROW(InteractomeSnapshot(file_snapshot, false));
+}
+
+// Path 0 - 1 - 2 without levels: offsets {0, 1, 3, 4} after the header and the padded node flags, then neighbors
+// {1, 0, 2, 1}. Overwrites the value at the byte position and loads without the checksum.
+template<typename T>
+void loadCorruptedSnapshot(std::size_t byte_position, T value) {
+    std::string file_snapshot = ::testing::TempDir() + "malformed.snapshot";
+    writeInteractomeSnapshot(file_snapshot, {}, {}, CSRAdjacency(3, {{0, 1}, {1, 2}}), {"A", "B", "C"},
+                             std::vector<std::uint8_t>(3, SNAPSHOT_NODE_PRESENT | SNAPSHOT_NODE_NAMED));
+    {
+        std::fstream f(file_snapshot, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(static_cast<std::streamoff>(byte_position));
+        f.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    InteractomeSnapshot snapshot(file_snapshot, false);
+}
+
+// Position of the int in the adjacency, counted in ints from the offsets
+std::size_t adjacencyPosition(int position) {
+    return sizeof(SnapshotHeader) + 8 + position * sizeof(int);
+}
+
+TEST(InteractomeSnapshotTest, MalformedAdjacencyThrowsExceptionWithoutChecksumTest) {
+    ASSERT_NO_THROW(loadCorruptedSnapshot(adjacencyPosition(1), 1));
+    ASSERT_THROW(loadCorruptedSnapshot(adjacencyPosition(1), 4), std::runtime_error);      // Offsets not monotonic
+    ASSERT_THROW(loadCorruptedSnapshot(adjacencyPosition(3), 3), std::runtime_error);      // Offsets end too soon
+    ASSERT_THROW(loadCorruptedSnapshot(adjacencyPosition(4 + 2), 3), std::runtime_error);  // Neighbor out of range
+    ASSERT_THROW(loadCorruptedSnapshot(adjacencyPosition(4 + 2), -1), std::runtime_error);
+
+    // Counts that make the section sizes wrap around to the size of the file
+    const std::uint64_t wrap_ints = std::uint64_t(1) << 62, wrap_words = std::uint64_t(1) << 61;
+    ASSERT_THROW(loadCorruptedSnapshot(offsetof(SnapshotHeader, num_entries), 4 + wrap_ints), std::runtime_error);
+    ASSERT_THROW(loadCorruptedSnapshot(offsetof(SnapshotHeader, num_vertices), 3 + wrap_words), std::runtime_error);
+    ASSERT_THROW(loadCorruptedSnapshot(offsetof(SnapshotHeader, names_size), ~std::uint64_t(0) - 4),
+                 std::runtime_error);
+    ASSERT_THROW(loadCorruptedSnapshot(offsetof(SnapshotHeader, num_levels), ~std::uint32_t(0)), std::runtime_error);
+}
+
+// Level ranges of a snapshot are checked like the ranges read from text
+TEST(InteractomeSnapshotTest, UnsortedLevelRangesThrowExceptionTest) {
+    std::string file_snapshot = ::testing::TempDir() + "unsorted_levels.snapshot";
+    writeInteractomeSnapshot(file_snapshot, {2, 0}, {2, 1}, CSRAdjacency(3, {{0, 1}, {1, 2}}), {"A", "B", "C"},
+                             std::vector<std::uint8_t>(3, SNAPSHOT_NODE_PRESENT | SNAPSHOT_NODE_NAMED));
+    EXPECT_THROW(Interactome{InteractomeSnapshot(file_snapshot)}, std::invalid_argument);
+
+    writeInteractomeSnapshot(file_snapshot, {0, 1}, {1, 2}, CSRAdjacency(3, {{0, 1}, {1, 2}}), {"A", "B", "C"},
+                             std::vector<std::uint8_t>(3, SNAPSHOT_NODE_PRESENT | SNAPSHOT_NODE_NAMED));
+    EXPECT_THROW(Interactome{InteractomeSnapshot(file_snapshot)}, std::invalid_argument);     // Overlapping
+
+    writeInteractomeSnapshot(file_snapshot, {0, 3}, {0, 1}, CSRAdjacency(3, {{0, 1}, {1, 2}}), {"A", "B", "C"},
+                             std::vector<std::uint8_t>(3, SNAPSHOT_NODE_PRESENT | SNAPSHOT_NODE_NAMED));
+    EXPECT_THROW(Interactome{InteractomeSnapshot(file_snapshot)}, std::invalid_argument);     // Inverted
+}
+
+// Induced subgraph: keeps only the interactions between members of the set
+TEST_F(InteractomeFixture, InducedSubgraphTest) {
+    base::dynamic_bitset<> members(4);
+    members[0].set();  // Nodes 1, 2 and 4, starting at node 1
+    members[1].set();
+    members[3].set();
+
+    auto subgraph = interactome.getInducedSubgraph(members, 1);
+
+    EXPECT_THAT(subgraph.vertices, ::testing::ElementsAre(1, 2, 4));
+    EXPECT_THAT(subgraph.offsets, ::testing::ElementsAre(0, 1, 2, 2));
+    EXPECT_THAT(subgraph.neighbors, ::testing::ElementsAre(2, 1));
+    EXPECT_EQ(1, subgraph.numEdges());
+}
+
+// Induced subgraphs: the batched extraction matches the extraction of each set
+TEST_F(InteractomeFixture, InducedSubgraphsBatchTest) {
+    std::vector<std::pair<int, int>> edges;
+    for (int node = 0; node < 200; node++)
+        edges.emplace_back(node, (node * 37 + 11) % 200);
+    Interactome network(edges);
+    vb members(20, base::dynamic_bitset<>(200));
+    for (int set = 0; set < 20; set++)
+        for (int node = set; node < 200; node += set + 2)
+            members[set][node].set();
+
+    auto subgraphs = network.getInducedSubgraphs(members, 0, 3);
+
+    ASSERT_EQ(20, subgraphs.size());
+    for (int set = 0; set < 20; set++) {
+        auto subgraph = network.getInducedSubgraph(members[set]);
+        EXPECT_EQ(subgraph.vertices, subgraphs[set].vertices);
+        EXPECT_EQ(subgraph.neighbors, subgraphs[set].neighbors);
+        for (std::size_t row = 0; row < subgraph.vertices.size(); row++)
+            for (int entry = subgraph.offsets[row]; entry < subgraph.offsets[row + 1]; entry++)
+                EXPECT_TRUE(members[set][subgraph.neighbors[entry]]);
+    }
+}
+
+// Induced subgraphs of hybrid sets, sparse and dense, match the ones of the same bitsets
+TEST_F(InteractomeFixture, InducedSubgraphsOfHybridSetsTest) {
+    std::vector<std::pair<int, int>> edges;
+    for (int node = 0; node < 200; node++)
+        edges.emplace_back(node, (node * 37 + 11) % 200);
+    Interactome network(edges);
+    vb members(20, base::dynamic_bitset<>(190));
+    std::vector<HybridSet> hybrid_members;
+    for (int set = 0; set < 20; set++) {
+        for (int node = set; node < 190; node += set / 4 + 1)
+            members[set][node].set();
+        hybrid_members.emplace_back(members[set]);
+    }
+    EXPECT_EQ(HybridSet::Representation::dense, hybrid_members[0].getRepresentation());
+    EXPECT_EQ(HybridSet::Representation::sorted, hybrid_members[19].getRepresentation());
+
+    auto subgraphs = network.getInducedSubgraphs(members, 10, 3);
+    auto hybrid_subgraphs = network.getInducedSubgraphs(hybrid_members, 10, 3);
+    ASSERT_EQ(20, hybrid_subgraphs.size());
+    for (int set = 0; set < 20; set++) {
+        EXPECT_EQ(subgraphs[set].vertices, hybrid_subgraphs[set].vertices);
+        EXPECT_EQ(subgraphs[set].offsets, hybrid_subgraphs[set].offsets);
+        EXPECT_EQ(subgraphs[set].neighbors, hybrid_subgraphs[set].neighbors);
+    }
+}
+
+// Path 0-1-2-3 and vertex 4 outside the range, connected to 0
+TEST(MultiSourceBFSTest, DistanceRowsTest) {
+    CSRAdjacency adjacency(5, {{0, 1}, {1, 2}, {2, 3}, {0, 4}});
+    MultiSourceBFS bfs(adjacency, 0, 4);
+    std::vector<int> sources = {0, 3, 0};
+
+    auto rows = bfs.getDistanceRows(sources);
+    ASSERT_EQ(3, rows.size());
+    EXPECT_THAT(rows[0], ::testing::ElementsAre(0, 1, 2, 3));
+    EXPECT_THAT(rows[1], ::testing::ElementsAre(3, 2, 1, 0));
+    EXPECT_EQ(rows[0], rows[2]);
+
+    auto histograms = bfs.getDistanceHistograms(sources);
+    EXPECT_THAT(histograms[1], ::testing::ElementsAre(1, 1, 1, 1));
+
+    std::vector<int> too_many(MultiSourceBFS::MAX_SOURCES + 1, 0);
+    EXPECT_THROW(bfs.traverse(too_many, [](int, int, std::span<const std::uint64_t>) {}), std::invalid_argument);
+    EXPECT_THROW((void) bfs.getDistanceRows(std::vector<int>{4}), std::invalid_argument);
+}
+
+// More sources than one batch, on a random graph with several components
+TEST(MultiSourceBFSTest, MatchesSingleSourceBFSTest) {
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<int> vertex(0, 399);
+    std::vector<std::pair<int, int>> edges;
+    for (int I = 0; I < 500; I++)
+        edges.emplace_back(vertex(generator), vertex(generator));
+    CSRAdjacency adjacency(400, edges);
+    MultiSourceBFS bfs(adjacency);
+
+    std::vector<int> sources;
+    for (int I = 0; I < 600; I++)
+        sources.push_back(vertex(generator));
+    auto rows = bfs.getDistanceRows(sources, 2);
+    auto histograms = bfs.getDistanceHistograms(sources, 2);
+
+    for (std::size_t source = 0; source < sources.size(); source += 37) {
+        std::vector<int> distances(400, MultiSourceBFS::UNREACHABLE);
+        std::queue<int> queue;
+        distances[sources[source]] = 0;
+        queue.push(sources[source]);
+        while (!queue.empty()) {
+            int current = queue.front();
+            queue.pop();
+            for (int neighbor : adjacency.getNeighbors(current))
+                if (distances[neighbor] == MultiSourceBFS::UNREACHABLE) {
+                    distances[neighbor] = distances[current] + 1;
+                    queue.push(neighbor);
+                }
+        }
+        std::vector<std::size_t> histogram;
+        for (int distance : distances) {
+            if (distance == MultiSourceBFS::UNREACHABLE)
+                continue;
+            histogram.resize(std::max<std::size_t>(histogram.size(), distance + 1), 0);
+            histogram[distance]++;
+        }
+        EXPECT_TRUE(std::equal(distances.begin(), distances.end(), rows[source].begin(), rows[source].end()));
+        EXPECT_EQ(histogram, histograms[source]);
+    }
+}
+
+// Vertices [1, 12) of a random graph, 11 vertices so the rows are padded
+TEST(DistanceMatrixTest, WriteAndQueryTest) {
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<int> vertex(0, 12);
+    std::vector<std::pair<int, int>> edges;
+    for (int I = 0; I < 12; I++)
+        edges.emplace_back(vertex(generator), vertex(generator));
+    CSRAdjacency adjacency(13, edges);
+    std::string file_matrix = ::testing::TempDir() + "distances.bin";
+    writeDistanceMatrix(file_matrix, adjacency, 1, 12, 2);
+
+    DistanceMatrix matrix(file_matrix);
+    ASSERT_EQ(11, matrix.numVertices());
+    EXPECT_EQ(1, matrix.getFirstVertex());
+    std::vector<int> sources(11);
+    std::iota(sources.begin(), sources.end(), 0);
+    auto rows = MultiSourceBFS(adjacency, 1, 12).getDistanceRows(sources);
+    for (int source = 0; source < 11; source++) {
+        EXPECT_TRUE(std::ranges::equal(rows[source], matrix.getRow(source + 1)));
+        EXPECT_EQ(rows[source][3], matrix.getDistance(source + 1, 4));
+    }
+
+    base::dynamic_bitset<> set(11);
+    set[2].set();
+    set[5].set();
+    const base::dynamic_bitset<> &module = set;
+    EXPECT_EQ(0, matrix.getDistance(3, module));
+    EXPECT_EQ(rows[5][2], matrix.getDistance(6, module, true));     // Node 6 is member 5, only member 2 is left
+    EXPECT_THROW((void) matrix.getDistance(0, 1), std::out_of_range);
+    EXPECT_THROW((void) matrix.getDistance(1, base::dynamic_bitset<>(12)), std::invalid_argument);
+}
+
+// The counts of the header would make the size of the rows wrap around to the size of the file
+TEST(DistanceMatrixTest, MalformedHeaderThrowsExceptionTest) {
+    std::string file_matrix = ::testing::TempDir() + "malformed_distances.bin";
+    writeDistanceMatrix(file_matrix, CSRAdjacency(8, {{0, 1}}), 0, 8);
+    ASSERT_NO_THROW(DistanceMatrix{file_matrix});
+    {
+        const std::uint64_t counts[2] = {(std::uint64_t(1) << 63) + 8, (std::uint64_t(1) << 63) + 8};
+        std::fstream f(file_matrix, std::ios::in | std::ios::out | std::ios::binary);
+        f.seekp(offsetof(DistanceMatrixHeader, num_vertices));
+        f.write(reinterpret_cast<const char *>(counts), sizeof(counts));
+    }
+    EXPECT_THROW(DistanceMatrix(file_matrix, false), std::runtime_error);
+}
+
+TEST(DistanceMatrixTest, WrongFileThrowsExceptionTest) {
+    std::string file_matrix = ::testing::TempDir() + "not_distances.bin";
+    std::ofstream(file_matrix) << "Not a distance matrix, but long enough for the header.";
+    EXPECT_THROW(DistanceMatrix{file_matrix}, std::runtime_error);
+}
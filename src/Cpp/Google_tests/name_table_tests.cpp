@@ -0,0 +1,148 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include <name_table.hpp>
+#include <bimap_str_int.hpp>
+#include <string_sort.hpp>
+
+TEST(NameTableTests, InternReturnsSameIndexForSameName) {
+    NameTable names;
+    EXPECT_EQ(0, names.intern("P01308"));
+    EXPECT_EQ(1, names.intern("P01308;00046:27"));
+    EXPECT_EQ(0, names.intern(std::string("P01") + "308"));
+    EXPECT_EQ(2, names.size());
+    EXPECT_EQ("P01308;00046:27", names[1]);
+}
+
+TEST(NameTableTests, FindMissingNameReturnsMinusOne) {
+    NameTable names;
+    names.intern("A");
+    EXPECT_EQ(-1, names.find("B"));
+    EXPECT_FALSE(names.contains(""));
+    EXPECT_TRUE(names.contains("A"));
+}
+
+// The handles stay valid while the table grows over many arena blocks and hash table sizes
+TEST(NameTableTests, HandlesSurviveGrowth) {
+    NameTable names;
+    std::string_view first = names[names.intern("first")];
+    for (int I = 0; I < 50000; I++)
+        names.intern("proteoform_" + std::to_string(I) + std::string(I % 7, ';'));
+
+    EXPECT_EQ("first", first);
+    EXPECT_EQ(50001, names.size());
+    for (int I = 0; I < 50000; I += 997)
+        EXPECT_EQ(I + 1, names.find("proteoform_" + std::to_string(I) + std::string(I % 7, ';')));
+}
+
+TEST(NameTableTests, CopyHasSameIndexes) {
+    NameTable names;
+    names.intern("X");
+    names.intern("Y");
+    NameTable copy(names);
+    names.intern("Z");
+
+    EXPECT_EQ(2, copy.size());
+    EXPECT_EQ(1, copy.find("Y"));
+    EXPECT_EQ(-1, copy.find("Z"));
+}
+
+// The bimap assigns the indexes in lexicographic order and removes repeated elements
+TEST(NameTableTests, BimapFromVectorTest) {
+    Bimap_str_int bimap(vs{"C", "A", "B", "A"});
+
+    EXPECT_EQ(3, bimap.size());
+    EXPECT_EQ(0, bimap.index("A"));
+    EXPECT_EQ(2, bimap.index(std::string("C")));
+    EXPECT_EQ("B", bimap.name(1));
+    EXPECT_EQ(-1, bimap.index("D"));
+    EXPECT_FALSE(bimap.has("D"));
+}
+
+TEST(NameTableTests, EmptyNameIsANameTest) {
+    NameTable names;
+    EXPECT_EQ(0, names.intern(""));
+    EXPECT_EQ(0, names.find(""));
+    EXPECT_EQ("", names[0]);
+}
+
+TEST(NameTableTests, PerfectHashFindsEveryNameTest) {
+    NameTable names;
+    for (int I = 0; I < 20000; I++)
+        names.intern("gene_" + std::to_string(I));
+    ASSERT_TRUE(names.buildPerfectHash());
+    ASSERT_TRUE(names.hasPerfectHash());
+
+    for (int I = 0; I < 20000; I++)
+        EXPECT_EQ(I, names.find("gene_" + std::to_string(I)));
+    EXPECT_EQ(-1, names.find("gene_20000"));
+    EXPECT_EQ(-1, names.find(""));
+
+    names.intern("gene_20000");    // Adding names drops the perfect hash
+    EXPECT_FALSE(names.hasPerfectHash());
+    EXPECT_EQ(20000, names.find("gene_20000"));
+}
+
+TEST(NameTableTests, CopyKeepsThePerfectHashTest) {
+    NameTable names;
+    for (int I = 0; I < 100; I++)
+        names.intern("gene_" + std::to_string(I));
+    ASSERT_TRUE(names.buildPerfectHash());
+
+    NameTable copy(names);
+    NameTable assigned;
+    assigned.intern("other");
+    assigned = names;
+    for (const NameTable *table : {&copy, &assigned}) {
+        ASSERT_TRUE(table->hasPerfectHash());
+        for (int I = 0; I < 100; I++)
+            EXPECT_EQ(I, table->find("gene_" + std::to_string(I)));
+        EXPECT_EQ(-1, table->find("other"));
+    }
+}
+
+TEST(NameTableTests, BimapPerfectHashTest) {
+    Bimap_str_int bimap(vs{"P04637", "P31749", "Q9Y6K9"});
+    ASSERT_TRUE(bimap.buildPerfectHash());
+
+    EXPECT_EQ(1, bimap.index("P31749"));
+    EXPECT_EQ(-1, bimap.index("P00000"));
+    EXPECT_TRUE(bimap.has("Q9Y6K9"));
+}
+
+TEST(NameTableTests, SortUniqueMatchesSortAndUniqueTest) {
+    std::mt19937 generator(7);
+    std::vector<std::string> strings;
+    for (int I = 0; I < 100000; I++) {    // Short strings over a small alphabet, so there are many repeated ones
+        std::string s(generator() % 6, 'A');
+        for (auto &c : s)
+            c = static_cast<char>('A' + generator() % 4);
+        strings.push_back(s);
+    }
+    std::vector<std::string_view> expected(strings.begin(), strings.end()), result = expected;
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+    sortUnique(result, 4);
+    EXPECT_EQ(expected, result);
+}
+
+TEST(NameTableTests, CreateIntToStrSortsTheColumnTest) {
+    std::string file_mapping = ::testing::TempDir() + "proteins_to_proteoforms.tsv";
+    std::ofstream(file_mapping) << "protein\tproteoform\n"
+                                << "P31749\tP31749;00046:473\n"
+                                << "P04637\tP04637 \r\n"
+                                << "\n"
+                                << "P31749\tP31749;00046:473\n"
+                                << "P04637\tP04637;00046:15";
+
+    EXPECT_EQ((vs{"P04637", "P04637;00046:15", "P31749;00046:473"}), createIntToStr(file_mapping, true, 1, 2, 3));
+    EXPECT_EQ((vs{"P04637", "P31749"}), createIntToStr(file_mapping, true, 0, 2, 2));
+
+    Bimap_str_int bimap(file_mapping, true, 1, 2);
+    EXPECT_EQ(3, bimap.size());
+    EXPECT_EQ(2, bimap.index("P31749;00046:473"));
+}
@@ -0,0 +1,83 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <string>
+#include <vector>
+#include <proteoform.hpp>
+
+using namespace proteoform;
+
+namespace {
+    std::vector<std::pair<std::string, int>> collectModifications(std::string_view proteoform) {
+        std::vector<std::pair<std::string, int>> result;
+        forEachModification(proteoform, [&](const Modification &modification) {
+            result.emplace_back(modification.mod, modification.position);
+        });
+        return result;
+    }
+}
+
+TEST(ProteoformTests, ParseCanonicalAccessionTest) {
+    ProteoformParts parts = parseProteoform("P31749");
+    EXPECT_EQ("P31749", parts.accession);
+    EXPECT_EQ("", parts.isoform);
+    EXPECT_EQ("", parts.modifications);
+    EXPECT_FALSE(isModified("P31749"));
+    EXPECT_EQ("P31749", getAccession("P31749"));
+}
+
+TEST(ProteoformTests, ParseIsoformAccessionTest) {
+    ProteoformParts parts = parseProteoform("P12345-2;00046:27,00047:30");
+    EXPECT_EQ("P12345", parts.accession);
+    EXPECT_EQ("2", parts.isoform);
+    EXPECT_EQ("00046:27,00047:30", parts.modifications);
+    EXPECT_EQ("P12345", getAccession("P12345-2;00046:27"));
+
+    ProteoformParts unmodified = parseProteoform("Q9Y6K9-10");
+    EXPECT_EQ("Q9Y6K9", unmodified.accession);
+    EXPECT_EQ("10", unmodified.isoform);
+    EXPECT_EQ("", unmodified.modifications);
+    EXPECT_FALSE(isModified("Q9Y6K9-10"));
+}
+
+TEST(ProteoformTests, NullPositionIsMinusOneTest) {
+    EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"00046", -1}, {"00048", 12}, {"01234", -1}}),
+              collectModifications("P04637;00046:null,00048:12,01234"));
+    EXPECT_TRUE(isModified("P04637;00046:null"));
+}
+
+TEST(ProteoformTests, RepeatedModificationsAreAllReportedTest) {
+    EXPECT_EQ((std::vector<std::pair<std::string, int>>{{"00046", 15}, {"00046", 20}, {"00046", -1}}),
+              collectModifications("P04637;00046:15,00046:20,00046:null"));
+    EXPECT_EQ((vs{"00046", "00047", "00046"}), getModifications("P04637-3;00046:15,00047:15,00046:20"));
+}
+
+TEST(ProteoformTests, ShortIdentifiersAreNotModificationsTest) {
+    EXPECT_FALSE(isModified("P04637;0046:15"));
+    EXPECT_FALSE(isModified("P04637;"));
+    EXPECT_EQ((vs{"00047"}), getModifications("P04637;046:15,00047:16"));
+}
+
+TEST(ProteoformTests, MalformedModificationThrowsExceptionTest) {
+    EXPECT_THROW(isModified("P04637;00046:abc"), std::invalid_argument);
+    EXPECT_THROW(isModified("P04637;00046:"), std::invalid_argument);
+    EXPECT_THROW(isModified("P04637;00046:15x,00047:16"), std::invalid_argument);
+    EXPECT_THROW(isModified("P04637;000461:15"), std::invalid_argument);
+    EXPECT_THROW(isModified("P04637;00046:nullx"), std::invalid_argument);
+    EXPECT_THROW(ProteoformTable(vs{"P04637;00046:15", "P31749;00046:?"}), std::invalid_argument);
+}
+
+TEST(ProteoformTests, TableMatchesParserTest) {
+    vs proteoforms = {"P04637", "P12345-2;00046:27,00046:null", "Q9Y6K9;00047:5"};
+    ProteoformTable table(proteoforms);
+
+    ASSERT_EQ(3, table.size());
+    EXPECT_EQ("P12345", table.getAccession(1));
+    EXPECT_EQ("2", table.getIsoform(1));
+    EXPECT_EQ("", table.getIsoform(2));
+    EXPECT_FALSE(table.isModified(0));
+    EXPECT_TRUE(table.isModified(2));
+    ASSERT_EQ(2, table.getModifications(1).size());
+    EXPECT_EQ("00046", table.getModifications(1)[1].mod);
+    EXPECT_EQ(-1, table.getModifications(1)[1].position);
+    EXPECT_EQ(5, table.getModifications(2)[0].position);
+}
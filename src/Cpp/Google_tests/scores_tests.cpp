@@ -0,0 +1,554 @@
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <type_traits>
+#include <scores.hpp>
+#include <bit_matrix.hpp>
+#include <crosstalk.hpp>
+#include <entity_index.hpp>
+#include <interface_engine.hpp>
+#include <module_distances.hpp>
+#include <similarity_queries.hpp>
+
+class ScoresFixture : public ::testing::Test {
+
+protected:
+    virtual void SetUp() override {
+        std::mt19937 generator(7);
+        std::bernoulli_distribution member(0.05);
+        for (int I = 0; I < 60; I++) {
+            sets.push_back(base::dynamic_bitset<>(300));
+            for (int J = 0; J < 300; J++)
+                if (member(generator))
+                    sets.back()[J].set();
+        }
+    }
+
+    // Graph over the vertices [0, num_vertices) with num_edges random edges
+    static CSRAdjacency randomAdjacency(unsigned seed, int num_vertices, int num_edges) {
+        std::mt19937 generator(seed);
+        std::uniform_int_distribution<int> vertex(0, num_vertices - 1);
+        std::vector<std::pair<int, int>> edges;
+        for (int I = 0; I < num_edges; I++)
+            edges.emplace_back(vertex(generator), vertex(generator));
+        return CSRAdjacency(num_vertices, edges);
+    }
+
+    vb sets;
+};
+
+// Get scores for pairs of sets: Correct number of pairs
+TEST_F(ScoresFixture, AllPairsCorrectPairs) {
+    // Create 4 sets of 5 members.
+    vb empty_sets(4, base::dynamic_bitset<>(5));
+
+    auto scores = getScores(empty_sets, getOverlapSimilarity, 0, 6);
+
+    EXPECT_EQ((empty_sets.size() * (empty_sets.size() - 1)) / 2, scores.size());
+}
+
+// Get scores for pairs of sets: the parallel tiles produce the same pairs as the serial calculation
+TEST_F(ScoresFixture, AllPairsSameWithAnyNumberOfThreads) {
+    auto serial = getScores(sets, getJaccardSimilarity, 5, 25, 1);
+    auto parallel = getScores(sets, getJaccardSimilarity, 5, 25, 4);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (const auto &entry : serial) {
+        ASSERT_LT(entry.first.first, entry.first.second);
+        ASSERT_EQ(parallel.at(entry.first), entry.second);
+    }
+}
+
+// Get scores for pairs of sets: sets outside the size limits are left out
+TEST_F(ScoresFixture, AllPairsRespectModuleSizes) {
+    auto scores = getScores(sets, getOverlapSize, 15, 20);
+
+    for (const auto &entry : scores) {
+        EXPECT_GE(sets[entry.first.first].count(), 15);
+        EXPECT_LE(sets[entry.first.first].count(), 20);
+        EXPECT_GE(sets[entry.first.second].count(), 15);
+        EXPECT_LE(sets[entry.first.second].count(), 20);
+    }
+}
+
+// Jaccard similarity when both sets are empty
+TEST_F(ScoresFixture, JaccardBothEmpty) {
+    base::dynamic_bitset<> set1(5), set2(5);
+
+    EXPECT_EQ(1, getJaccardSimilarity(set1, set2));
+    EXPECT_EQ(1, getJaccardSimilarity(set2, set1));
+}
+
+// Jaccard similarity when they share a fraction of nodes
+TEST_F(ScoresFixture, JaccardFraction) {
+    base::dynamic_bitset<> set1(5), set2(5);
+
+    set1[0].set();
+    set1[1].set();
+    set2[1].set();
+    set2[2].set();
+
+    EXPECT_NEAR(0.33, getJaccardSimilarity(set1, set2), 1e-2);
+    EXPECT_NEAR(0.33, getJaccardSimilarity(set2, set1), 1e-2);
+}
+
+// Overlap similarity: one set is empty the other is not
+TEST_F(ScoresFixture, OverlapOneEmpty) {
+    base::dynamic_bitset<> set1(5), set2(5);
+    set1[1].set();
+    set1[2].set();
+
+    EXPECT_EQ(1, getOverlapSimilarity(set1, set2));
+    EXPECT_EQ(1, getOverlapSimilarity(set2, set1));
+}
+
+// Overlap similarity: sets share fraction of elements
+TEST_F(ScoresFixture, OverlapShareFraction) {
+    base::dynamic_bitset<> set1(5), set2(5);
+    for (int I = 0; I < 4; I++)  // 0, 1, 2, 3
+        set1[I].set();
+    for (int I = 1; I < 5; I++)  // 1, 2, 3, 4
+        set2[I].set();
+
+    EXPECT_NEAR(0.75, getOverlapSimilarity(set1, set2), 1e-2);
+    EXPECT_NEAR(0.75, getOverlapSimilarity(set2, set1), 1e-2);
+}
+
+// The fused counts match the counts of the materialized intersection and union
+TEST_F(ScoresFixture, FusedCountsMatchMaterializedSets) {
+    for (auto I = 0u; I + 1 < sets.size(); I++) {
+        auto counts = base::count_overlap(sets[I], sets[I + 1]);
+        EXPECT_EQ(counts.first, sets[I].count());
+        EXPECT_EQ(counts.second, sets[I + 1].count());
+        EXPECT_EQ(counts.intersection, (sets[I] & sets[I + 1]).count());
+        EXPECT_EQ(counts.union_size(), (sets[I] | sets[I + 1]).count());
+        EXPECT_EQ(base::count_intersection(sets[I], sets[I + 1]), counts.intersection);
+    }
+}
+
+// Module sets: cached cardinalities and block ranges
+TEST_F(ScoresFixture, ModuleSetsCacheCardinalityAndBlocks) {
+    vb module_vertices(3, base::dynamic_bitset<>(200));
+    module_vertices[0][40].set();
+    module_vertices[0][70].set();
+    module_vertices[1][150].set();
+    ModuleSets module_sets(module_vertices);
+
+    EXPECT_EQ(2, module_sets.cardinality(0));
+    EXPECT_EQ(1, module_sets.firstBlock(0));
+    EXPECT_EQ(3, module_sets.endBlock(0));
+    EXPECT_EQ(0, module_sets.cardinality(2));
+    EXPECT_FALSE(module_sets.mayIntersect(0, 1));
+    EXPECT_FALSE(module_sets.mayIntersect(0, 2));
+    EXPECT_TRUE(module_sets.mayIntersect(0, 0));
+    EXPECT_THAT(module_sets.select(1, 5), ::testing::ElementsAre(1, 0));
+}
+
+// The module sets and the interface engine refer to the sets, so they do not take temporaries
+static_assert(!std::is_constructible_v<ModuleSets, vb>);
+static_assert(std::is_constructible_v<ModuleSets, const vb &>);
+static_assert(!std::is_constructible_v<InterfaceEngine, vb, const CSRAdjacency &>);
+static_assert(std::is_constructible_v<InterfaceEngine, const vb &, const CSRAdjacency &>);
+
+// Skipping disjoint pairs does not change the overlap sizes
+TEST_F(ScoresFixture, SkipDisjointKeepsOverlapSizes) {
+    ModuleSets module_sets(sets);
+    auto all = getScores(module_sets, getOverlapSize, 0, 300, false);
+    auto skipping = getScores(module_sets, getOverlapSize, 0, 300, true);
+
+    EXPECT_EQ(all, skipping);
+}
+
+// Hybrid sets: the representation follows the number of members
+TEST(HybridSetTest, RepresentationGrowsWithMembers) {
+    HybridSet set(1 << 20);
+    EXPECT_EQ(HybridSet::Representation::sorted, set.getRepresentation());
+
+    for (int I = 0; I < 1000; I++)
+        set.insert(I * 7);
+    EXPECT_EQ(HybridSet::Representation::chunked, set.getRepresentation());
+    EXPECT_EQ(1000, set.count());
+    EXPECT_TRUE(set.contains(700));
+    EXPECT_FALSE(set.contains(701));
+
+    for (int I = 0; I < (1 << 20); I += 8)
+        set.insert(I);
+    EXPECT_EQ(HybridSet::Representation::dense, set.getRepresentation());
+    EXPECT_TRUE(set.contains(7));
+    EXPECT_TRUE(set.contains(16));
+    EXPECT_FALSE(set.contains(17));
+}
+
+// Hybrid sets: members outside the universe are rejected
+TEST(HybridSetTest, InsertOutsideUniverseThrowsException) {
+    HybridSet set(10);
+    EXPECT_THROW(set.insert(10), std::out_of_range);
+    EXPECT_THROW(set.insert(-1), std::out_of_range);
+}
+
+// Hybrid sets: intersections between every combination of representations match the bitset intersections
+TEST(HybridSetTest, MixedIntersectionsMatchBitsets) {
+    const int universe = 300000;
+    std::mt19937 generator(11);
+    std::vector<base::dynamic_bitset<>> bitsets;
+    // Sorted, chunked with offset arrays, chunked with one bitmap chunk (the members crowd in the first chunk), dense
+    for (auto [density, end] : {std::pair{0.0001, universe}, {0.002, universe}, {0.2, 70000}, {0.2, universe}}) {
+        std::bernoulli_distribution member(density);
+        bitsets.emplace_back(universe);
+        for (int J = 0; J < end; J++)
+            if (member(generator))
+                bitsets.back()[J].set();
+    }
+    std::vector<HybridSet> sets(bitsets.begin(), bitsets.end());
+    EXPECT_EQ(HybridSet::Representation::sorted, sets[0].getRepresentation());
+    EXPECT_EQ(HybridSet::Representation::chunked, sets[1].getRepresentation());
+    EXPECT_EQ(HybridSet::Representation::chunked, sets[2].getRepresentation());
+    EXPECT_EQ(HybridSet::Representation::dense, sets[3].getRepresentation());
+
+    for (auto I = 0u; I < sets.size(); I++) {
+        EXPECT_EQ(bitsets[I], sets[I].toBitset());
+        for (auto J = 0u; J < sets.size(); J++) {
+            auto counts = countOverlap(sets[I], sets[J]);
+            EXPECT_EQ(bitsets[I].count(), counts.first);
+            EXPECT_EQ((bitsets[I] & bitsets[J]).count(), counts.intersection) << I << " " << J;
+            EXPECT_DOUBLE_EQ(getJaccardSimilarity(bitsets[I], bitsets[J]), getJaccardSimilarity(sets[I], sets[J]));
+        }
+    }
+}
+
+// Get scores for pairs of hybrid sets: same pairs and scores as with the bitsets
+TEST_F(ScoresFixture, HybridSetScoresMatchBitsetScores) {
+    std::vector<HybridSet> hybrid_sets(sets.begin(), sets.end());
+
+    EXPECT_EQ(getScores(sets, getOverlapSimilarity, 5, 25), getScores(hybrid_sets, getOverlapSimilarity, 5, 25, 2));
+    EXPECT_EQ(getScores(sets, getOverlapSize, 0, 300), getScores(hybrid_sets, getOverlapSize, 0, 300));
+}
+
+// Entity index: the postings list the modules of each entity in order
+TEST_F(ScoresFixture, EntityIndexPostings) {
+    vb module_vertices(3, base::dynamic_bitset<>(10));
+    module_vertices[0][2].set();
+    module_vertices[0][5].set();
+    module_vertices[2][5].set();
+    EntityIndex index(module_vertices);
+
+    EXPECT_EQ(3, index.numModules());
+    EXPECT_EQ(10, index.numEntities());
+    EXPECT_THAT(std::vector<int>(index.getModules(5).begin(), index.getModules(5).end()), ::testing::ElementsAre(0, 2));
+    EXPECT_TRUE(index.getModules(3).empty());
+    EXPECT_THAT(std::vector<int>(index.getEntities(0).begin(), index.getEntities(0).end()), ::testing::ElementsAre(2, 5));
+    EXPECT_EQ(0, index.cardinality(1));
+}
+
+// Get scores from the entity index: same overlapping pairs as the all-pairs calculation
+TEST_F(ScoresFixture, EntityIndexScoresMatchAllPairsScores) {
+    EntityIndex index(sets);
+
+    EXPECT_EQ(getScores(sets, getOverlapSize, 0, 300), getScores(index, getOverlapSize, 0, 300, 1));
+    EXPECT_EQ(getScores(sets, getOverlapSize, 12, 18), getScores(index, getOverlapSize, 12, 18, 3));
+
+    auto jaccard = getScores(index, getJaccardSimilarity, 5, 25);
+    for (const auto &entry : getScores(sets, getJaccardSimilarity, 5, 25))
+        EXPECT_DOUBLE_EQ(entry.second, jaccard.at(entry.first));
+}
+
+// Bit matrix: the blocked kernel counts the same intersections, over several tiles and panels
+TEST(BitMatrixTest, IntersectionCountsMatchBitsets) {
+    std::mt19937 generator(11);
+    std::bernoulli_distribution member(0.1);
+    vb module_vertices(150, base::dynamic_bitset<>(3000));
+    for (auto &vertices : module_vertices)
+        for (int J = 0; J < 3000; J++)
+            if (member(generator))
+                vertices[J].set();
+    BitMatrix matrix(module_vertices);
+
+    auto counts = matrix.countIntersections(3);
+    ASSERT_EQ(150 * 150, counts.size());
+    for (int I = 0; I < 150; I += 7)
+        for (int J = 0; J < 150; J += 5)
+            EXPECT_EQ(base::count_intersection(module_vertices[I], module_vertices[J]), counts[I * 150 + J]);
+    EXPECT_EQ(module_vertices[4][2999], matrix.get(4, 2999));
+    EXPECT_THROW(BitMatrix(vb{base::dynamic_bitset<>(3), base::dynamic_bitset<>(4)}), std::invalid_argument);
+}
+
+// Get scores from the bit matrix: same pairs and scores as the all-pairs calculation
+TEST_F(ScoresFixture, BitMatrixScoresMatchAllPairsScores) {
+    BitMatrix matrix(sets);
+
+    EXPECT_EQ(getScores(sets, getOverlapSize, 0, 300), getScores(matrix, getOverlapSize, 0, 300, 2));
+    auto jaccard = getScores(matrix, getJaccardSimilarity, 5, 25);
+    auto expected = getScores(sets, getJaccardSimilarity, 5, 25);
+    ASSERT_EQ(expected.size(), jaccard.size());
+    for (const auto &entry : expected)
+        EXPECT_DOUBLE_EQ(entry.second, jaccard.at(entry.first));
+}
+
+// Threshold query: same pairs as filtering the all-pairs Jaccard scores
+TEST_F(ScoresFixture, JaccardPairsMatchFilteredAllPairsScores) {
+    EntityIndex index(sets);
+    for (double threshold : {0.05, 0.1, 0.2, 1.0}) {
+        pair_map<double> expected;
+        for (const auto &entry : getScores(sets, getJaccardSimilarity, 1, 300)) {
+            if (entry.second >= threshold)
+                expected.insert(entry);
+        }
+        EXPECT_EQ(expected, getJaccardPairs(index, threshold, 1, 300, 2));
+    }
+    EXPECT_THROW(getJaccardPairs(index, 0.0, 1, 300), std::invalid_argument);
+}
+
+// Top partners: the best k of the all-pairs scores of each module
+TEST_F(ScoresFixture, TopPartnersMatchBestAllPairsScores) {
+    EntityIndex index(sets);
+    std::vector<partner_list> expected(sets.size());
+    for (const auto &entry : getScores(sets, getJaccardSimilarity, 0, 300)) {
+        expected[entry.first.first].emplace_back(entry.first.second, entry.second);
+        expected[entry.first.second].emplace_back(entry.first.first, entry.second);
+    }
+
+    auto top = getTopPartners(index, getJaccardSimilarity, 3, 0, 300, 2);
+    ASSERT_EQ(sets.size(), top.size());
+    for (std::size_t module = 0; module < sets.size(); module++) {
+        std::sort(expected[module].begin(), expected[module].end(), [](const auto &partner1, const auto &partner2) {
+            return partner1.second > partner2.second
+                   || (partner1.second == partner2.second && partner1.first < partner2.first);
+        });
+        expected[module].resize(std::min<std::size_t>(3, expected[module].size()));
+        EXPECT_EQ(expected[module], top[module]);
+    }
+}
+
+// Pair map: (i, j) and (j, i) are different keys, and the pairs survive growing the table
+TEST(PairMapTest, StoresPairsInOrder) {
+    pair_map<double> scores;
+    scores[{1, 2}] = 0.5;
+    scores[{2, 1}] = 0.25;
+    for (int I = 0; I < 1000; I++)
+        scores.emplace(std::make_pair(I, I + 3), I);
+
+    EXPECT_EQ(1002, scores.size());
+    EXPECT_EQ(0.5, scores.at({1, 2}));
+    EXPECT_EQ(0.25, scores.at({2, 1}));
+    EXPECT_EQ(999, scores.at({999, 1002}));
+    EXPECT_FALSE(scores.contains({3, 0}));
+    EXPECT_THROW(scores.at({3, 0}), std::out_of_range);
+    EXPECT_FALSE(scores.insert({{1, 2}, 1.0}).second);
+    EXPECT_EQ(0.5, scores.begin()->second);    // Insertion order
+}
+
+// Triangular result: zero is a value like any other, only the pairs never set are absent
+TEST(PairMapTest, TriangularKeepsZeroScores) {
+    TriangularPairMap<double> scores(4);
+    scores[{2, 0}] = 0.0;
+    scores[{1, 3}] = 0.5;
+    scores[{3, 1}] = 0.75;
+
+    EXPECT_EQ(2, scores.size());
+    EXPECT_TRUE(scores.contains({0, 2}));
+    EXPECT_FALSE(scores.contains({0, 1}));
+    EXPECT_EQ(0.75, scores(1, 3));
+    std::vector<std::pair<int, int>> pairs;
+    scores.forEach([&](int index1, int index2, double) { pairs.emplace_back(index1, index2); });
+    EXPECT_THAT(pairs, ::testing::ElementsAre(std::make_pair(0, 2), std::make_pair(1, 3)));
+    EXPECT_EQ(0.0, scores.toPairMap().at({0, 2}));
+}
+
+// Triangular result: same scores as the pair map
+TEST_F(ScoresFixture, TriangularScoresMatchPairMapScores) {
+    auto expected = getScores(sets, getJaccardSimilarity, 5, 25);
+    auto triangle = getScores<TriangularPairMap<double>>(sets, getJaccardSimilarity, 5, 25, 2);
+
+    EXPECT_EQ(sets.size(), triangle.numModules());
+    EXPECT_EQ(expected.size(), triangle.size());
+    EXPECT_EQ(expected, triangle.toPairMap());
+    auto entry = *expected.begin();
+    EXPECT_EQ(entry.second, triangle(entry.first.second, entry.first.first));
+}
+
+// Path 1-2-3-4-5 and isolated vertex 6 over the level of vertices [1, 7), vertex 0 is outside the level.
+// A = {1, 2, 3}, B = {3, 4}, C = {6}
+TEST(InterfaceEngineTest, CountsInterfaceNodesAndEdges) {
+    CSRAdjacency adjacency(7, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}});
+    vb sets(3, base::dynamic_bitset<>(6));
+    for (int member : {0, 1, 2})
+        sets[0][member].set();
+    for (int member : {2, 3})
+        sets[1][member].set();
+    sets[2][5].set();
+
+    InterfaceEngine engine(sets, adjacency, 1, 2);
+    EXPECT_EQ(4, engine.getNeighborhood(0).count());
+    EXPECT_EQ(3, engine.getIncidentEdges(0).size());
+
+    EXPECT_EQ(3, engine.countInterfaceNodes(0, 1));      // 2, 3 and 4
+    EXPECT_EQ(3, engine.countInterfaceEdges(0, 1));      // 2-3, 3-4 and 4-5
+    EXPECT_EQ(engine.countInterfaceEdges(0, 1), engine.countInterfaceEdges(1, 0));
+    EXPECT_EQ(0, engine.countInterfaceNodes(0, 2));
+    EXPECT_EQ(1, engine.countInterfaceEdges(0, 2));      // 3-4 leaves A
+
+    pair_map<double> prev_scores;
+    prev_scores[{0, 1}] = 0.5;
+    prev_scores[{0, 2}] = 0.0;
+    auto scores = getScores(engine, InterfaceMeasure::edges, prev_scores, 2);
+    ASSERT_EQ(2, scores.size());
+    EXPECT_EQ(3.0, scores.at({0, 1}));
+    EXPECT_EQ(1.0, scores.at({0, 2}));
+}
+
+// The per pair functions over an adjacency list give the engine counts: the graph above, in level indexes
+TEST(InterfaceEngineTest, PairFunctionsMatchEngine) {
+    vusi edges(6);
+    for (auto [vertex1, vertex2] : std::vector<std::pair<int, int>>{{0, 1}, {1, 2}, {2, 3}, {3, 4}}) {
+        edges[vertex1].insert(vertex2);
+        edges[vertex2].insert(vertex1);
+    }
+    vb sets(3, base::dynamic_bitset<>(6));
+    for (int member : {0, 1, 2})
+        sets[0][member].set();
+    for (int member : {2, 3})
+        sets[1][member].set();
+    sets[2][5].set();
+
+    EXPECT_EQ(3.0, calculate_interface_size_nodes(sets[0], sets[1], edges));
+    EXPECT_EQ(3.0, calculate_interface_size_edges(sets[0], sets[1], edges));
+    EXPECT_EQ(0.0, calculate_interface_size_nodes(sets[0], sets[2], edges));
+    EXPECT_EQ(1.0, calculate_interface_size_edges(sets[0], sets[2], edges));
+
+    pair_map<double> prev_scores;
+    prev_scores[{0, 1}] = 0.5;
+    auto scores = getScores(sets, edges, calculate_interface_size_nodes, prev_scores);
+    ASSERT_EQ(1, scores.size());
+    EXPECT_EQ(3.0, scores.at({0, 1}));
+}
+
+// Random graph over the level [5, 305), with edges also to vertices outside the level
+TEST_F(ScoresFixture, CrosstalkMatchesEdgeScan) {
+    CSRAdjacency adjacency = randomAdjacency(11, 310, 1500);
+
+    CrosstalkMatrix crosstalk(sets, adjacency, 5);
+    auto scores = getScores(crosstalk, 0, 100, 3);
+
+    std::size_t num_pairs = 0;
+    for (std::size_t module1 = 0; module1 < sets.size(); module1++) {
+        for (std::size_t module2 = module1 + 1; module2 < sets.size(); module2++) {
+            double count = 0;
+            for (int vertex = 5; vertex < 305; vertex++)
+                if (sets[module1][vertex - 5])
+                    for (int neighbor : adjacency.getNeighbors(vertex))
+                        count += 5 <= neighbor && neighbor < 305 && sets[module2][neighbor - 5];
+            if (count > 0) {
+                num_pairs++;
+                ASSERT_TRUE(scores.contains({module1, module2}));
+                EXPECT_EQ(count, scores.at({module1, module2}));
+            }
+        }
+    }
+    EXPECT_EQ(num_pairs, scores.size());
+    EXPECT_EQ(0, getScores(crosstalk, 100, 200).size());
+}
+
+// Path 0-1-2-3-4-5 with A = {0, 1}, B = {4, 5}, C = {2}
+TEST(ModuleDistancesTest, SeparationOnPathTest) {
+    CSRAdjacency adjacency(6, {{0, 1}, {1, 2}, {2, 3}, {3, 4}, {4, 5}});
+    MultiSourceBFS bfs(adjacency);
+    vb sets(3, base::dynamic_bitset<>(6));
+    sets[0][0].set();
+    sets[0][1].set();
+    sets[1][4].set();
+    sets[1][5].set();
+    sets[2][2].set();
+
+    ModuleDistances distances(bfs, sets, 2);
+    EXPECT_DOUBLE_EQ(1.0, distances.getWithinDistance(0));
+    EXPECT_TRUE(std::isnan(distances.getWithinDistance(2)));
+    EXPECT_DOUBLE_EQ(3.5, distances.getShortestDistance(0, 1));
+    EXPECT_DOUBLE_EQ(2.5, distances.getSeparation(1, 0));
+    EXPECT_DOUBLE_EQ(4.0 / 3.0, distances.getShortestDistance(0, 2));
+
+    auto separations = getScores(distances, ModuleDistance::separation, 0, 10, 2);
+    ASSERT_EQ(1, separations.size());
+    EXPECT_DOUBLE_EQ(2.5, separations.at({0, 1}));
+    EXPECT_EQ(3, getScores(distances, ModuleDistance::shortest, 0, 10).size());
+    EXPECT_THROW(ModuleDistances(bfs, vb(1, base::dynamic_bitset<>(5))), std::invalid_argument);
+}
+
+// Path 0-1-2 with A = B = {0, 1}: the distance between the modules is 0 and must be stored
+TEST(ModuleDistancesTest, TriangularScoresKeepZeroDistancesTest) {
+    MultiSourceBFS bfs(CSRAdjacency(3, {{0, 1}, {1, 2}}));
+    vb sets(2, base::dynamic_bitset<>(3));
+    for (auto &set : sets) {
+        set[0].set();
+        set[1].set();
+    }
+
+    ModuleDistances distances(bfs, sets);
+    auto scores = getScores<TriangularPairMap<double>>(distances, ModuleDistance::shortest, 0, 10, 2);
+    ASSERT_EQ(1, scores.size());
+    EXPECT_TRUE(scores.contains({0, 1}));
+    EXPECT_EQ(0.0, scores(0, 1));
+}
+
+// The fixture sets over a random graph, against the distance rows of every member
+TEST_F(ScoresFixture, ModuleDistancesMatchDistanceRows) {
+    MultiSourceBFS bfs(randomAdjacency(13, 300, 400));
+    ModuleDistances distances(bfs, sets, 3);
+
+    std::vector<int> all_vertices(300);
+    std::iota(all_vertices.begin(), all_vertices.end(), 0);
+    auto rows = bfs.getDistanceRows(all_vertices, 3);
+    auto nearest = [&](int member, const base::dynamic_bitset<> &set, bool skip_member) {
+        int distance = MultiSourceBFS::UNREACHABLE;
+        for (int other = 0; other < 300; other++)
+            if (set[other] && !(skip_member && other == member))
+                distance = std::min<int>(distance, rows[member][other]);
+        return distance;
+    };
+
+    for (std::size_t module1 = 0; module1 < sets.size(); module1++) {
+        double sum = 0, count = 0;
+        for (int member = 0; member < 300; member++) {
+            if (sets[module1][member] && nearest(member, sets[module1], true) != MultiSourceBFS::UNREACHABLE) {
+                sum += nearest(member, sets[module1], true);
+                count++;
+            }
+        }
+        if (count > 0) {
+            EXPECT_DOUBLE_EQ(sum / count, distances.getWithinDistance(module1));
+        } else {
+            EXPECT_TRUE(std::isnan(distances.getWithinDistance(module1)));
+        }
+
+        for (std::size_t module2 = module1 + 1; module2 < sets.size(); module2 += 7) {
+            double pair_sum = 0, pair_count = 0;
+            for (auto [from, to] : {std::make_pair(module1, module2), std::make_pair(module2, module1)}) {
+                for (int member = 0; member < 300; member++) {
+                    if (sets[from][member] && nearest(member, sets[to], false) != MultiSourceBFS::UNREACHABLE) {
+                        pair_sum += nearest(member, sets[to], false);
+                        pair_count++;
+                    }
+                }
+            }
+            if (pair_count > 0) {
+                EXPECT_DOUBLE_EQ(pair_sum / pair_count, distances.getShortestDistance(module1, module2));
+            }
+        }
+    }
+}
+
+// Same distances from the precomputed matrix as from the traversals
+TEST_F(ScoresFixture, ModuleDistancesFromMatrixMatchTraversals) {
+    CSRAdjacency adjacency = randomAdjacency(17, 300, 400);
+    std::string file_matrix = ::testing::TempDir() + "module_distances.bin";
+    writeDistanceMatrix(file_matrix, adjacency, 0, 300, 2);
+
+    ModuleDistances from_matrix(DistanceMatrix(file_matrix), sets, 3);
+    ModuleDistances from_traversals(MultiSourceBFS(adjacency), sets, 3);
+    auto expected = getScores(from_traversals, ModuleDistance::separation, 0, 100);
+    auto separations = getScores(from_matrix, ModuleDistance::separation, 0, 100, 2);
+    ASSERT_EQ(expected.size(), separations.size());
+    for (const auto &[pair, separation] : expected)
+        EXPECT_DOUBLE_EQ(separation, separations.at(pair));
+}
@@ -3,7 +3,7 @@
 Module::Module(const std::string &name, Level level, int maxNumVertices) :
         name(name),
         level(level),
-        accessioned_entity_vertices(base::dynamic_bitset<>(maxNumVertices)) {
+        accessioned_entity_vertices(maxNumVertices) {
 
     //    std::cout << "Module for " << LEVELS[level] << " constructed with " << maxNumVertices << std::endl;
 }
@@ -16,11 +16,11 @@ void Module::addVertex(int vertex) {
 // Add vertex to the adjacency list and to the bitset for overlap operations
 void Module::addVertex(int interactomeIndex, unsigned int moduleBitsetIndex) {
     adj[interactomeIndex];
-    if(moduleBitsetIndex >= accessioned_entity_vertices.size()){
-        std::cerr << "Tried to add entity out of index range:" << moduleBitsetIndex << ". Max index: " << accessioned_entity_vertices.size()-1 << std::endl;
+    if(moduleBitsetIndex >= accessioned_entity_vertices.universeSize()){
+        std::cerr << "Tried to add entity out of index range:" << moduleBitsetIndex << ". Max index: " << accessioned_entity_vertices.universeSize()-1 << std::endl;
         std::cerr << "Level: " << LEVELS[level] << std::endl;
     } else{
-        accessioned_entity_vertices[moduleBitsetIndex] = true;
+        accessioned_entity_vertices.insert(moduleBitsetIndex);
     }
 }
 
@@ -40,6 +40,15 @@ void Module::addEdges(std::vector<std::pair<int, int>> edges) {
     }
 }
 
+void Module::addEdges(const InducedSubgraph &subgraph) {
+    for (std::size_t row = 0; row < subgraph.vertices.size(); row++) {
+        auto &neighbors = adj[subgraph.vertices[row]];
+        for (int entry = subgraph.offsets[row]; entry < subgraph.offsets[row + 1]; entry++)
+            if (subgraph.neighbors[entry] != subgraph.vertices[row])
+                neighbors.insert(neighbors.end(), subgraph.neighbors[entry]);
+    }
+}
+
 bool Module::hasVertex(int index) {
     return adj.find(index) != adj.end();
 }
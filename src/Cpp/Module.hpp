@@ -7,6 +7,7 @@
 #include <set>
 #include <vector>
 #include "Interactome.hpp"
+#include "hybrid_set.hpp"
 #include "types.hpp"
 
 class Module {
@@ -22,7 +23,7 @@ public:
 
     Module(const std::string &name, Level level, int maxNumVertices);
 
-    base::dynamic_bitset<> accessioned_entity_vertices;
+    HybridSet accessioned_entity_vertices;
 
     void addVertex(int vertex);
 
@@ -32,6 +33,9 @@ public:
 
     void addEdges(std::vector<std::pair<int, int>> edges);
 
+    // Adds the vertices and edges of the subgraph. The rows are sorted, so the neighbors are appended with a hint.
+    void addEdges(const InducedSubgraph &subgraph);
+
     bool hasVertex(int index);
 
     std::vector<int> getVertices();
@@ -226,7 +226,7 @@ namespace base {
          }
 
          constexpr std::size_t count( ) const noexcept {
-            return transform_reduce(block_begin( ), block_end( ), std::size_t(0), std::plus{ }, FUNCTOR(popcount));
+            return base::transform_reduce(block_begin( ), block_end( ), std::size_t(0), std::plus{ }, FUNCTOR(popcount));
          }
 
          constexpr std::size_t count_n(std::size_t i, std::size_t n) const noexcept {
@@ -723,6 +723,76 @@ namespace base {
 
    template<typename T = unsigned, typename A = std::allocator<T>>
    using dynamic_bitset = impl::bitset_base_<impl::dynamic_bitset_<T, A>>;
+
+
+   struct overlap_count {
+      std::size_t first;
+      std::size_t second;
+      std::size_t intersection;
+
+      constexpr std::size_t union_size( ) const noexcept {
+         return first + second - intersection;
+      }
+   };
+
+   // |A|, |B| and |A & B| in one pass over the blocks, without temporaries. The bitsets should have the same size;
+   // blocks past the end of the shorter one only count for its partner.
+   template<typename B>
+   constexpr overlap_count count_overlap(const impl::bitset_base_<B>& a, const impl::bitset_base_<B>& b) noexcept {
+      constexpr std::size_t ancho = 4;
+      const auto comunes = std::min(a.blocks( ), b.blocks( ));
+      const auto pa = a.block_begin( ), pb = b.block_begin( );
+
+      // Independent accumulators so the popcounts of consecutive blocks do not wait on each other
+      std::size_t ca[ancho] = { }, cb[ancho] = { }, ci[ancho] = { };
+      std::size_t i = 0;
+      for (; i + ancho <= comunes; i += ancho) {
+         for (std::size_t j = 0; j < ancho; ++j) {
+            ca[j] += popcount(pa[i + j]);
+            cb[j] += popcount(pb[i + j]);
+            ci[j] += popcount(pa[i + j] & pb[i + j]);
+         }
+      }
+
+      overlap_count res = { };
+      for (std::size_t j = 0; j < ancho; ++j) {
+         res.first += ca[j], res.second += cb[j], res.intersection += ci[j];
+      }
+      for (; i < comunes; ++i) {
+         res.first += popcount(pa[i]);
+         res.second += popcount(pb[i]);
+         res.intersection += popcount(pa[i] & pb[i]);
+      }
+      for (auto k = comunes; k < a.blocks( ); ++k) {
+         res.first += popcount(pa[k]);
+      }
+      for (auto k = comunes; k < b.blocks( ); ++k) {
+         res.second += popcount(pb[k]);
+      }
+      return res;
+   }
+
+   // |A & B| in one pass over the blocks, without temporaries.
+   template<typename B>
+   constexpr std::size_t count_intersection(const impl::bitset_base_<B>& a, const impl::bitset_base_<B>& b) noexcept {
+      constexpr std::size_t ancho = 4;
+      const auto comunes = std::min(a.blocks( ), b.blocks( ));
+      const auto pa = a.block_begin( ), pb = b.block_begin( );
+
+      std::size_t ci[ancho] = { };
+      std::size_t i = 0;
+      for (; i + ancho <= comunes; i += ancho) {
+         for (std::size_t j = 0; j < ancho; ++j) {
+            ci[j] += popcount(pa[i + j] & pb[i + j]);
+         }
+      }
+
+      std::size_t res = ci[0] + ci[1] + ci[2] + ci[3];
+      for (; i < comunes; ++i) {
+         res += popcount(pa[i] & pb[i]);
+      }
+      return res;
+   }
 }
 
 #endif
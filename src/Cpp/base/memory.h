@@ -71,7 +71,7 @@ namespace base {
       aligned_storage<sizeof(T), alignof(T)> mem_;
    };
 
-   template<typename T, std::size_t N> requires alignof(T) >= base::pow2(N)
+   template<typename T, std::size_t N> requires (alignof(T) >= base::pow2(N))
    class disguised_ptr {
    public:
       constexpr disguised_ptr( ) noexcept
@@ -424,7 +424,7 @@ namespace base {
       using impl::unique_arr_<T, false, A>::unique_arr_;
    };
 
-   template<typename T, typename A> requires !(std::is_trivially_destructible_v<T> && ignores_deallocation_size_v<A>)
+   template<typename T, typename A> requires (!(std::is_trivially_destructible_v<T> && ignores_deallocation_size_v<A>))
    struct unique_ptr<T[], A> : public impl::unique_arr_<T, true, A> {
       using impl::unique_arr_<T, true, A>::unique_arr_;
    };
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include "phegeni_reader.hpp"
+
+// Synthetic association file with the PheGenI columns, written once for all the benchmarks.
+const std::string &getSyntheticPheGenIFile() {
+    static const std::string file_phegeni = [] {
+        std::string path = std::string(P_tmpdir) + "/phegeni_benchmark.tsv";
+        std::ofstream f(path);
+        f << "#\tTrait\tSNP rs\tContext\tGene\tGene ID\tGene 2\tGene ID 2\tChromosome\tLocation\tP-Value\tSource\t"
+             "PubMed\tAnalysis ID\tStudy ID\tStudy Name\n";
+        std::mt19937 generator(3);
+        std::uniform_int_distribution<int> trait(0, 999), gene(0, 19999);
+        for (int row = 0; row < 500000; row++) {
+            f << row << "\tTrait number " << trait(generator) << "\t" << 1000 + row << "\tintron_variant\tGENE"
+              << gene(generator) << "\t" << row << "\tGENE" << gene(generator) << "\t" << row << "\t7\t" << 1234567
+              << "\t1.0E-8\tNHGRI\t" << 20000000 + row << "\t" << row << "\t" << row
+              << "\tGenome-wide association study of a trait\n";
+        }
+        return path;
+    }();
+    return file_phegeni;
+}
+
+static void BM_PheGenIReader(benchmark::State &state) {
+    const std::string &file_phegeni = getSyntheticPheGenIFile();
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        PheGenIReader reader(file_phegeni);
+        std::size_t gene_characters = 0;
+        reader.forEachAssociation([&](const PheGenIAssociation &association) {
+            gene_characters += association.gene.size() + association.gene_2.size() + association.trait;
+        });
+        benchmark::DoNotOptimize(gene_characters);
+        bytes += reader.fileSize();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+BENCHMARK(BM_PheGenIReader)->Unit(benchmark::kMillisecond);
+
+// The previous reading: one getline per column into strings, and a map search by trait name per row.
+static void BM_PheGenIGetline(benchmark::State &state) {
+    const std::string &file_phegeni = getSyntheticPheGenIFile();
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::ifstream f(file_phegeni);
+        std::string line, field, trait, gene_name, gene_name_2, p_value;
+        std::map<std::string, int> traits;
+        std::size_t gene_characters = 0;
+        getline(f, line);
+        while (getline(f, field, '\t')) {
+            getline(f, trait, '\t');
+            getline(f, field, '\t');
+            getline(f, field, '\t');
+            getline(f, gene_name, '\t');
+            getline(f, field, '\t');
+            getline(f, gene_name_2, '\t');
+            getline(f, field, '\t');
+            getline(f, field, '\t');
+            getline(f, field, '\t');
+            getline(f, p_value, '\t');
+            getline(f, line);
+            auto entry = traits.emplace(trait, static_cast<int>(traits.size())).first;
+            gene_characters += gene_name.size() + gene_name_2.size() + entry->second;
+        }
+        benchmark::DoNotOptimize(gene_characters);
+        bytes += std::filesystem::file_size(file_phegeni);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+BENCHMARK(BM_PheGenIGetline)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -1,233 +1,193 @@
 #include "create_modules.hpp"
 
-//void saveModules(std::map<std::string, Module> modules, const std::string &output_path);
-//
-//// Create or read module files at the three levels: all in one, and single module files.
-//// One file with the list of diseases and for each disease a module file for each level
-//std::map<std::string, Module> createGeneModules(std::string_view file_phegeni,
-//                                                Interactome interactome,
-//                                                const std::string &path_output) {
-//
-//    std::cout << "Creating gene level modules...\n";
-//
-//    // Read traits and genes in Phegeni file. The genes used are the ones from Reactome, if the gene read is not there it is ignored.
-//    std::ifstream file_phegen(file_phegeni.data());
-//    std::string line, field, trait, gene_name, gene_name_2;
-//    std::string p_value_str;
-//
-//    std::map<std::string, Module> modules;
-//    int numGenes = interactome.getEndIndexGenes() - interactome.getStartIndexGenes() + 1;
-//
-//    if (!file_phegen.is_open()) {
-//        std::string message = "Cannot open path_file_phegeni at ";
-//        std::string function = __FUNCTION__;
-//        throw std::runtime_error(message + function);
-//    }
-//
-//    getline(file_phegen, line);                  // Read header line
-//    while (getline(file_phegen, field, '\t')) {  // Read #
-//        getline(file_phegen, trait, '\t');        // Read Trait
-//        getline(file_phegen, field, '\t');        // Read SNP rs
-//        getline(file_phegen, field, '\t');        // Read Context
-//        getline(file_phegen, gene_name, '\t');         //	Gene
-//        getline(file_phegen, field, '\t');        //	Gene ID
-//        getline(file_phegen, gene_name_2, '\t');        //	Gene 2
-//        getline(file_phegen, field, '\t');        //	Gene ID 2
-//        getline(file_phegen, field, '\t');        // Read Chromosome
-//        getline(file_phegen, field, '\t');        // Read Location
-//        getline(file_phegen, p_value_str, '\t');  // Read P-Value
-//        getline(file_phegen,
-//                line);               // Skip header line leftoever: Source,	PubMed,	Analysis ID,	Study ID,	Study Name
-//
-//        if (modules.find(trait) == modules.end()) {
-//            modules.emplace(trait, Module(trait, genes, numGenes));
-//        }
-//        int index;
-//        if ((index = interactome.index(gene_name)) > 0) {
-////            std::cout << "Adding " << interactome.getName(index) << " to module: " << trait << std::endl;
-//            modules.at(trait).addVertex(index, index - interactome.getStartIndexGenes());
-//            for (int simpleEntity : interactome.getSimpleEntityNeighbors(index))
-//                modules.at(trait).addVertex(simpleEntity);
-//        }
-//
-//        if ((index = interactome.index(gene_name_2)) > 0) {
-////            std::cout << "Adding " << interactome.getName(index) << " to module: " << trait << std::endl;
-//            modules.at(trait).addVertex(index, index - interactome.getStartIndexGenes());
-//            for (int simpleEntity : interactome.getSimpleEntityNeighbors(index))
-//                modules.at(trait).addVertex(simpleEntity);
-//        }
-//    }
-//
-//    modules.at(trait).addEdges(interactome.getInteractions(modules.at(trait).getVertices()));
-//
-//    for (auto entry : modules) {
-//        Module &module = entry.second;
-//        std::ofstream f(path_output.data() + module.getName() + "_" + "genes.tsv");
-//
-//        for (auto vertex : module.getVertices()) {
-//            if (module.getNeighbors(vertex).size() == 0) {
-//                f << vertex << "\t" << vertex << "\n";
-//            } else {
-//                for (auto neighbor : module.getNeighbors(vertex)) {
-//                    f << vertex << "\t" << neighbor << "\n";
-//                }
-//            }
-//        }
-//    }
-//
-//    saveModules(modules, path_output);
-//
-//    std::cerr << "Created " << modules.size() << " gene level disease modules\n";
-//
-//    return modules;
-//}
-//
-//std::map<std::string, Module> createProteinModules(std::map<std::string, Module> gene_modules,
-//                                                   Interactome interactome,
-//                                                   const std::string &output_path) {
-//
-//    std::cout << "Creating protein level modules...\n";
-//
-//    std::map<std::string, Module> protein_modules;
-//    for (auto &entry : gene_modules) {
-//        Module &gene_module = entry.second;
-//        Module protein_module = Module(gene_module.getName(), proteins,
-//                                       interactome.getEndIndexProteins() - interactome.getStartIndexProteins() + 1);
-//
-//        std::set<int> candidate_proteins;
-//        for (auto gene : gene_module.getVertices()) { // Gather all candidate proteins by converting ids
-//            if (interactome.isGene(gene)) {
-//                for (auto protein : interactome.getProteins(gene))
-//                    candidate_proteins.insert(protein);
-//            }
-//        }
-//
-//        bool filterCandidateProteins = false;
-//        if (filterCandidateProteins) {
-//            for (auto candidate_protein : candidate_proteins) { // Keep only those with interactors in the same set
-//                for (auto neighbor : interactome.getProteinNeighbors(candidate_protein)) {
-//                    if (candidate_proteins.find(neighbor) !=
-//                        candidate_proteins.end()) { // If the  neighbor is a protein
-//                        protein_module.addVertex(candidate_protein,
-//                                                 candidate_protein - interactome.getStartIndexProteins());
-//                        for (int simpleEntity : interactome.getSimpleEntityNeighbors(candidate_protein))
-//                            protein_module.addVertex(simpleEntity);
-//                        break;
-//                    }
-//                }
-//            }
-//        } else {
-//            for (auto candidate_protein : candidate_proteins) {
-//                std::cout << "Adding " << interactome.getName(candidate_protein) << " to module: " << protein_module.getName()
-//                << " at index " << candidate_protein - interactome.getStartIndexProteins()
-//                << std::endl;
-//                protein_module.addVertex(candidate_protein, candidate_protein - interactome.getStartIndexProteins());
-//            }
-//        }
-//
-//        protein_module.addEdges(interactome.getInteractions(protein_module.getVertices()));
-//
-//        protein_modules.emplace(protein_module.getName(), protein_module);
-//    }
-//
-//    saveModules(protein_modules, output_path);
-//
-//    std::cerr << "Created " << protein_modules.size() << " protein level disease modules\n";
-//
-//    return protein_modules;
-//}
-//
-//std::map<std::string, Module> createProteoformModules(std::map<std::string, Module> protein_modules,
-//                                                      Interactome interactome,
-//                                                      const std::string &output_path) {
-//
-//    std::cout << "Creating proteoform level modules...\n";
-//
-//    std::map<std::string, Module> proteoform_modules;
-//    for (auto &entry : protein_modules) {
-//        Module &protein_module = entry.second;
-//        Module proteoform_module = Module(
-//                protein_module.getName(),
-//                proteoforms,
-//                interactome.getEndIndexProteoforms() - interactome.getStartIndexProteoforms() - 1);
-//
-//        std::set<int> candidate_proteoforms;
-//        for (auto vertex : protein_module.getVertices()) { // Gather all candidate proteins by converting ids
-//            if (interactome.isProtein(vertex)) {
-//                for (auto proteoform : interactome.getProteoforms(vertex))
-//                    candidate_proteoforms.insert(proteoform);
-//            }
-//        }
-//
-//        bool filterCandidateProteoforms = false;
-//
-//        if (filterCandidateProteoforms) {
-//            for (auto candidate_proteoform : candidate_proteoforms) { // Keep only those with interactors in the same set
-//                for (auto neighbor : interactome.getProteoformNeighbors(candidate_proteoform)) {
-//                    if (candidate_proteoforms.find(neighbor) != candidate_proteoforms.end()) {
-//                        proteoform_module.addVertex(candidate_proteoform,
-//                                                    candidate_proteoform - interactome.getStartIndexProteoforms());
-//                        for (int simpleEntity :interactome.getSimpleEntityNeighbors(candidate_proteoform))
-//                            proteoform_module.addVertex(simpleEntity);
-//                        break;
-//                    }
-//                }
-//            }
-//        } else {
-//            for (auto canditate_proteoform : candidate_proteoforms) {
-//                proteoform_module.addVertex(canditate_proteoform,
-//                                            canditate_proteoform - interactome.getStartIndexProteoforms());
-//            }
-//        }
-//
-//        proteoform_module.addEdges(interactome.getInteractions(proteoform_module.getVertices()));
-//
-//        proteoform_modules.emplace(proteoform_module.getName(), proteoform_module);
-//    }
-//
-//    saveModules(proteoform_modules, output_path);
-//
-//    std::cerr << "Created " << proteoform_modules.size() << " proteoform level disease modules\n";
-//    return proteoform_modules;
-//
-//}
-//
-//void saveModules(std::map<std::string, Module> modules, const std::string &output_path) {
-//
-//    std::cout << "Saving modules at " << output_path << std::endl;
-//
-//    for (auto entry : modules) {
-//        Module &module = entry.second;
-//        std::string file_name = output_path.data() + module.getName() + "_" + LEVELS[module.getLevel()] + ".tsv";
-//        std::ofstream f(file_name);
-//
-//        if (!f.is_open()) {
-//            std::string message = "Cannot open module file " + file_name + " at ";
-//            std::string function = __FUNCTION__;
-//            throw std::runtime_error(message + function);
-//        }
-//
-//        for (auto vertex : module.getVertices()) {
-//            if (module.getNeighbors(vertex).size() == 0) {
-//                f << vertex << "\t" << vertex << "\n";
-//            } else {
-//                for (auto neighbor : module.getNeighbors(vertex)) {
-//                    f << vertex << "\t" << neighbor << "\n";
-//                }
-//            }
-//        }
-//    }
-//}
-//
-//std::vector<std::map<std::string, Module>> createModules(std::string_view file_phegeni,
-//                                                         Interactome interactome,
-//                                                         const std::string &output_path) {
-//    std::map<std::string, Module> gene_modules = createGeneModules(file_phegeni, interactome, output_path);
-//    std::map<std::string, Module> protein_modules = createProteinModules(gene_modules, interactome, output_path);
-//    std::map<std::string, Module> proteoform_modules = createProteoformModules(protein_modules, interactome,
-//                                                                               output_path);
-//    return {gene_modules, protein_modules, proteoform_modules};
-//}
+// Modules are kept in a vector indexed by the interned trait while reading, so rows do not search the map by name.
+// Genes missing from the interactome are ignored. The interactions of a gene with its small molecules are added with
+// the gene; the interactions among the genes and among the small molecules of each module are then induced in one
+// batch per level.
+std::map<std::string, Module> createGeneModules(std::string_view file_phegeni, const Interactome &interactome,
+                                                int num_threads) {
+
+    std::cout << "Creating gene level modules...\n";
+
+    PheGenIReader reader(file_phegeni);
+    const int start_index_genes = interactome.getStartIndexGenes();
+    const int num_genes = interactome.getEndIndexGenes() - start_index_genes + 1;
+    const bool has_simple_entities = interactome.getNumLevels() > SimpleEntity;
+    const int start_index_simple_entities = has_simple_entities ? interactome.getStartIndex(SimpleEntity) : 0;
+    const int num_simple_entities = has_simple_entities
+                                    ? interactome.getEndIndex(SimpleEntity) - start_index_simple_entities + 1 : 0;
+    std::vector<Module> modules;
+    std::vector<HybridSet> simple_entity_members;
+
+    auto add_gene = [&](int trait, std::string_view gene_name) {
+        int index = interactome.getNodeIndex(gene_name);
+        if (!interactome.isGene(index))
+            return;
+        modules[trait].addVertex(index, index - start_index_genes);
+        if (has_simple_entities)
+            for (int simple_entity : interactome.getSimpleEntityNeighbors(index)) {
+                modules[trait].addEdge(index, simple_entity);
+                simple_entity_members[trait].insert(simple_entity - start_index_simple_entities);
+            }
+    };
+
+    reader.forEachAssociation([&](const PheGenIAssociation &association) {
+        if (association.trait == static_cast<int>(modules.size())) {    // First row of the trait
+            modules.emplace_back(std::string(reader.getTraitName(association.trait)), genes, num_genes);
+            simple_entity_members.emplace_back(num_simple_entities);
+        }
+        add_gene(association.trait, association.gene);
+        add_gene(association.trait, association.gene_2);
+    });
+
+    std::vector<HybridSet> gene_members;
+    for (const auto &module : modules)
+        gene_members.push_back(module.accessioned_entity_vertices);
+    auto gene_subgraphs = interactome.getInducedSubgraphs(gene_members, start_index_genes, num_threads);
+    auto simple_entity_subgraphs = interactome.getInducedSubgraphs(simple_entity_members,
+                                                                   start_index_simple_entities, num_threads);
+    for (std::size_t trait = 0; trait < modules.size(); trait++) {
+        modules[trait].addEdges(gene_subgraphs[trait]);
+        modules[trait].addEdges(simple_entity_subgraphs[trait]);
+    }
+
+    std::map<std::string, Module> result;
+    for (auto &module : modules)
+        result.emplace(module.getName(), std::move(module));
+
+    std::cerr << "Created " << result.size() << " gene level disease modules\n";
+
+    return result;
+}
+
+std::map<int, std::vector<int>> readGenesToProteins(std::string_view file_proteins_to_genes,
+                                                    const Interactome &interactome) {
+    std::ifstream f(file_proteins_to_genes.data());
+
+    if (!f.is_open()) {
+        std::string message = "Cannot open file_proteins_to_genes at ";
+        std::string function = __FUNCTION__;
+        throw std::runtime_error(message + function);
+    }
+
+    std::map<int, std::vector<int>> genes_to_proteins;
+    std::string protein_name, gene_name;
+    while (f >> protein_name >> gene_name) {
+        int gene_index = interactome.getNodeIndex(gene_name), protein_index = interactome.getNodeIndex(protein_name);
+        if (gene_index >= 0 && protein_index >= 0)
+            genes_to_proteins[gene_index].push_back(protein_index);
+    }
+    return genes_to_proteins;
+}
+
+std::map<int, std::vector<int>> readProteinsToProteoforms(std::string_view file_proteins_to_proteoforms,
+                                                          const Interactome &interactome) {
+    std::ifstream f(file_proteins_to_proteoforms.data());
+
+    if (!f.is_open()) {
+        std::string message = "Cannot open file_proteins_to_proteoforms at ";
+        std::string function = __FUNCTION__;
+        throw std::runtime_error(message + function);
+    }
+
+    std::map<int, std::vector<int>> proteins_to_proteoforms;
+    std::string protein_name, proteoform_name;
+    while (f >> protein_name >> proteoform_name) {
+        int protein_index = interactome.getNodeIndex(protein_name);
+        int proteoform_index = interactome.getNodeIndex(proteoform_name);
+        if (protein_index >= 0 && proteoform_index >= 0)
+            proteins_to_proteoforms[protein_index].push_back(proteoform_index);
+    }
+    return proteins_to_proteoforms;
+}
+
+// One file per module, <output_path><name>_<level>.tsv, with one "vertex<TAB>neighbor" line per interaction in both
+// directions, and "vertex<TAB>vertex" for the vertices without interactions.
+void saveModules(const std::map<std::string, Module> &modules, const std::string &output_path) {
+
+    std::cout << "Saving modules at " << output_path << std::endl;
+
+    for (const auto &entry : modules) {
+        const Module &module = entry.second;
+        std::string file_name = output_path + module.getName() + "_" + LEVELS[module.getLevel()] + ".tsv";
+        std::ofstream f(file_name);
+
+        if (!f.is_open()) {
+            std::string message = "Cannot open module file " + file_name + " at ";
+            std::string function = __FUNCTION__;
+            throw std::runtime_error(message + function);
+        }
+
+        for (const auto &[vertex, neighbors] : module.getAdj()) {
+            if (neighbors.empty()) {
+                f << vertex << "\t" << vertex << "\n";
+            } else {
+                for (int neighbor : neighbors)
+                    f << vertex << "\t" << neighbor << "\n";
+            }
+        }
+    }
+}
+
+namespace {
+
+    // Module with the entities start_index + i for every bit i set in members, and the interactions between them
+    Module createModule(const std::string &name, Level level, const base::dynamic_bitset<> &members,
+                        const InducedSubgraph &subgraph) {
+        Module module(name, level, static_cast<int>(members.size()));
+        module.accessioned_entity_vertices = HybridSet(members);
+        module.addEdges(subgraph);
+        return module;
+    }
+}
+
+// The gene modules come from one pass over the PheGenI file. Their member sets are then projected to the protein
+// and proteoform levels all at once, 64 traits per sweep over the level links, and the induced interactions of each
+// level are extracted in one batch. Finally each trait is a task that builds its two modules from its bitsets and
+// subgraphs. The tasks only read shared data and write the modules into their own slots, so they run without locks.
+std::vector<std::map<std::string, Module>> createModules(std::string_view file_phegeni,
+                                                         const Interactome &interactome,
+                                                         const LevelMappings &mappings,
+                                                         int num_threads) {
+    std::map<std::string, Module> gene_modules = createGeneModules(file_phegeni, interactome, num_threads);
+
+    std::vector<Module *> traits;
+    std::vector<HybridSet> gene_members;
+    for (auto &entry : gene_modules) {
+        traits.push_back(&entry.second);
+        gene_members.push_back(entry.second.accessioned_entity_vertices);
+    }
+
+    std::cout << "Creating protein and proteoform level modules...\n";
+
+    const LevelLinks genes_to_proteins(interactome, genes, proteins, mappings.genes_to_proteins);
+    const LevelLinks proteins_to_proteoforms(interactome, proteins, proteoforms, mappings.proteins_to_proteoforms);
+    vb protein_members = genes_to_proteins.expand(gene_members, num_threads);
+    vb proteoform_members = proteins_to_proteoforms.expand(protein_members, num_threads);
+    auto protein_subgraphs = interactome.getInducedSubgraphs(protein_members, interactome.getStartIndexProteins(),
+                                                             num_threads);
+    auto proteoform_subgraphs = interactome.getInducedSubgraphs(proteoform_members,
+                                                                interactome.getStartIndexProteoforms(), num_threads);
+
+    std::vector<std::optional<Module>> protein_slots(traits.size()), proteoform_slots(traits.size());
+    parallelFor(traits.size(), [&](std::size_t trait, int) {
+        const std::string &name = traits[trait]->getName();
+        protein_slots[trait].emplace(createModule(name, proteins, protein_members[trait], protein_subgraphs[trait]));
+        proteoform_slots[trait].emplace(createModule(name, proteoforms, proteoform_members[trait],
+                                                     proteoform_subgraphs[trait]));
+    }, num_threads);
+
+    std::map<std::string, Module> protein_modules, proteoform_modules;
+    for (std::size_t trait = 0; trait < traits.size(); trait++) {
+        protein_modules.emplace(traits[trait]->getName(), std::move(*protein_slots[trait]));
+        proteoform_modules.emplace(traits[trait]->getName(), std::move(*proteoform_slots[trait]));
+    }
+
+    std::cerr << "Created " << protein_modules.size() << " protein and " << proteoform_modules.size()
+              << " proteoform level disease modules\n";
+
+    return {std::move(gene_modules), std::move(protein_modules), std::move(proteoform_modules)};
+}
 
 
 /*
@@ -1,28 +1,49 @@
 #ifndef PROTEOFORMNETWORKS_CREATE_MODULES_HPP
 #define PROTEOFORMNETWORKS_CREATE_MODULES_HPP
 
+#include <map>
+#include <optional>
 #include <string_view>
+#include <vector>
 #include "Interactome.hpp"
+#include "level_links.hpp"
 #include "Module.hpp"
+#include "parallel.hpp"
+#include "phegeni_reader.hpp"
 #include <iostream>
 #include "overlap_analysis.hpp"
 
 // Create or read module files at the three levels: all in one, and single module files.
-std::map<std::string, Module> createGeneModules(std::string_view file_phegeni,
-                                                Interactome interactome,
-                                                const std::string &path_output);
 
-std::map<std::string, Module> createProteinModules(std::map<std::string, Module> gene_modules,
-                                                   Interactome interactome,
-                                                   const std::string &path_output);
+// Creates one gene level module per trait of the PheGenI file, with the genes of the trait found in the interactome,
+// their small molecule neighbors, and all the interactions among these members. The file is streamed with
+// PheGenIReader, and the interactions are induced by num_threads workers (0 uses all hardware threads).
+std::map<std::string, Module> createGeneModules(std::string_view file_phegeni, const Interactome &interactome,
+                                                int num_threads = 0);
 
-std::map<std::string, Module> createProteoformModules(std::map<std::string, Module> protein_modules,
-                                                      Interactome interactome,
-                                                      const std::string &output_path);
+// For each gene and protein, the interactome indexes of its products at the next level.
+// Read once and shared read-only by all the module builders.
+struct LevelMappings {
+    std::map<int, std::vector<int>> genes_to_proteins;
+    std::map<int, std::vector<int>> proteins_to_proteoforms;
+};
 
+// Reads the (protein, gene) name pairs into gene index -> protein indexes. Names not in the interactome are skipped.
+std::map<int, std::vector<int>> readGenesToProteins(std::string_view file_proteins_to_genes,
+                                                    const Interactome &interactome);
+
+// Reads the (protein, proteoform) name pairs into protein index -> proteoform indexes.
+std::map<int, std::vector<int>> readProteinsToProteoforms(std::string_view file_proteins_to_proteoforms,
+                                                          const Interactome &interactome);
+
+// Creates the gene, protein and proteoform modules of all the traits. The level links are built once from the
+// mappings and the traits are projected to the protein and proteoform levels in batches, in parallel by num_threads
+// workers (0 uses all hardware threads).
 std::vector<std::map<std::string, Module>>
-createModules(std::string_view file_phegeni, Interactome interactome, const std::string &output_path);
+createModules(std::string_view file_phegeni, const Interactome &interactome, const LevelMappings &mappings,
+              int num_threads = 0);
 
-void saveModules(std::map<std::string, Module> modules, const std::string &output_path);
+// Writes the vertices and interactions of each module to its own file in the output path, which is used as a prefix.
+void saveModules(const std::map<std::string, Module> &modules, const std::string &output_path);
 
 #endif //PROTEOFORMNETWORKS_CREATE_MODULES_HPP
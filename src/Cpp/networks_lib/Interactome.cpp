@@ -1,119 +1,179 @@
 #include "Interactome.hpp"
+#include <algorithm>
 
 Interactome::Interactome() {
 
 }
 
-Interactome::Interactome(std::vector<std::pair<int, int>> &interactions) {
+Interactome::Interactome(const std::vector<std::pair<int, int>> &interactions) {
+    addInteractions(interactions);
+    finalize();
+}
+
+Interactome::Interactome(const InteractomeSnapshot &snapshot) :
+        node_name_indexes(snapshot.numVertices(), -1),
+        node_present(snapshot.numVertices(), false),
+        adj(snapshot.getAdjacency()) {
+
+    for (int node = 0; node < snapshot.numVertices(); node++) {
+        node_present[node] = snapshot.isPresent(node);
+        if (!snapshot.isNamed(node))
+            continue;
+        node_name_indexes[node] = names.intern(snapshot.getName(node));
+        if (node_name_indexes[node] == static_cast<int>(name_nodes.size()))
+            name_nodes.push_back(node);
+    }
+    names.buildPerfectHash();
+    std::vector<int> starts, ends;
+    for (int level = 0; level < snapshot.numLevels(); level++) {
+        starts.push_back(snapshot.getStartIndex(level));
+        ends.push_back(snapshot.getEndIndex(level));
+    }
+    setLevelRanges(std::move(starts), std::move(ends));
+}
+
+void Interactome::writeSnapshot(std::string_view file_snapshot) const {
+    checkFinalized();
+    // Absent nodes and nodes with the default name are stored without a name
+    std::vector<std::string> node_names(node_name_indexes.size());
+    std::vector<std::uint8_t> node_flags(node_name_indexes.size(), 0);
+    for (int node = 0; node < static_cast<int>(node_name_indexes.size()); node++) {
+        if (hasNode(node))
+            node_flags[node] |= SNAPSHOT_NODE_PRESENT;
+        if (node_name_indexes[node] >= 0) {
+            node_flags[node] |= SNAPSHOT_NODE_NAMED;
+            node_names[node] = names[node_name_indexes[node]];
+        }
+    }
+    writeInteractomeSnapshot(file_snapshot, start_indexes, end_indexes, adj, node_names, node_flags);
+}
+
+void Interactome::addInteractions(const std::vector<std::pair<int, int>> &interactions) {
     for (auto &interaction: interactions) {
-        addNode(interaction.first);
-        addNode(interaction.second);
-        adj_list.at(interaction.first).insert(interaction.second);
-        adj_list.at(interaction.second).insert(interaction.first);
+        markNode(interaction.first);
+        markNode(interaction.second);
     }
+
+    pending_interactions.insert(pending_interactions.end(), interactions.begin(), interactions.end());
+}
+
+void Interactome::finalize() {
+    if (!hasPendingChanges())
+        return;
+    if (pending_interactions.empty()) {
+        adj.addIsolatedVertices(static_cast<int>(node_present.size()) - adj.numVertices());
+    } else {
+        std::vector<std::pair<int, int>> edges = adj.getEdges();
+        edges.insert(edges.end(), pending_interactions.begin(), pending_interactions.end());
+        adj = CSRAdjacency(static_cast<int>(node_present.size()), edges);
+        pending_interactions = {};
+    }
+    indexLevels();
+}
+
+void Interactome::checkFinalized() const {
+    if (hasPendingChanges())
+        throw std::logic_error("The interactome has nodes or interactions pending, call finalize() before reading "
+                               "the interactions.");
 }
 
 std::vector<int> Interactome::getNodes() const {
     std::vector<int> nodes;
 
-    for (auto &entry : adj_list)
-        nodes.push_back(entry.first);
+    for (int node = 0; node < static_cast<int>(node_present.size()); node++)
+        if (node_present[node])
+            nodes.push_back(node);
 
     return nodes;
 }
 
-void Interactome::addNode(int index) {
-    if(!hasNode(index)){
-        adj_list[index];
-        node_names[index] = std::to_string(index);
+// Registers the node, without touching the adjacency. Until names are read, the name of a node is its index.
+void Interactome::markNode(int index) {
+    if (index < 0)
+        throw std::invalid_argument("Provided negative node index: " + std::to_string(index));
+    if (hasNode(index))
+        return;
+
+    if (index >= static_cast<int>(node_present.size())) {
+        node_present.resize(index + 1, false);
+        node_name_indexes.resize(index + 1, -1);
     }
+    node_present[index] = true;
+}
+
+void Interactome::addNode(int index) {
+    markNode(index);
 }
 
-std::vector<int> Interactome::getInteractors(int node) const {
-    std::vector<int> neighbors(adj_list.at(node).begin(), adj_list.at(node).end());
-    return neighbors;
+std::span<const int> Interactome::getInteractors(int node) const {
+    checkFinalized();
+    if (!hasNode(node))
+        throw std::out_of_range("Provided invalid node index to get the interactors: " + std::to_string(node));
+    return adj.getNeighbors(node);
 }
 
 bool Interactome::hasNode(int node) const {
-    return adj_list.find(node) != adj_list.end();
+    return 0 <= node && node < static_cast<int>(node_present.size()) && node_present[node];
 }
 
 bool Interactome::hasNode(std::string_view name) const {
-    return node_indexes.find(name.data()) != node_indexes.end();
+    return getNodeIndex(name) >= 0;
+}
+
+int Interactome::getNodeIndex(std::string_view name) const {
+    int name_index = names.find(name);
+    return name_index >= 0 ? name_nodes[name_index] : -1;
 }
 
 void Interactome::readNodeNames(std::istream &s) {
-    node_names.clear();
-    std::unordered_set<std::string> names;
-    std::unordered_set<int> nodes_left_to_be_named;
+    NameTable names_read;
+    std::vector<int> name_indexes_read(node_present.size(), -1);
+    std::vector<int> name_nodes_read;
+    std::vector<bool> named(node_present.size(), false);
+    std::size_t nodes_left_to_be_named = getNodes().size();
 
     int node;
     std::string name;
 
-    for(auto& entry : adj_list) // Create list of which nodes still need a name
-        nodes_left_to_be_named.insert(entry.first);
-
     while (s >> node >> name) {
-        if(nodes_left_to_be_named.size() == 0)
+        if(nodes_left_to_be_named == 0)
             throw std::invalid_argument("Provided too many arguments to name the nodes.");
-        if(node_names.find(node) != node_names.end())
+        if(hasNode(node) && named[node])
             throw std::invalid_argument("Provided repeated node in the names stream: " + std::to_string(node));
         if(!hasNode(node))
             throw std::invalid_argument("Provided name for unexistent node: " + std::to_string(node));
 
-        if (names.find(name) != names.end())
+        int name_index = names_read.intern(name);
+        if (name_index < static_cast<int>(name_nodes_read.size()))
             throw std::invalid_argument("Provided repeated node name in the names stream: " + name);
 
-        node_names.emplace(node, name);
-        node_indexes.emplace(name, node);
-        names.insert(name);
-        nodes_left_to_be_named.erase(node);
+        name_indexes_read[node] = name_index;
+        name_nodes_read.push_back(node);
+        named[node] = true;
+        nodes_left_to_be_named--;
     }
-    if(names.size() < adj_list.size()){
+    if(nodes_left_to_be_named > 0){
         std::string missing = "";
-        for(auto node : nodes_left_to_be_named)
-            missing += std::to_string(node) + " ";
+        for(auto node : getNodes())
+            if (!named[node])
+                missing += std::to_string(node) + " ";
         throw std::invalid_argument("The names supplied are less than the number of nodes in the network: Missing nodes are: " + missing);
     }
+
+    names = std::move(names_read);
+    names.buildPerfectHash();     // The names are final, so lookups by name take a single probe
+    node_name_indexes = std::move(name_indexes_read);
+    name_nodes = std::move(name_nodes_read);
 }
 
 std::string Interactome::getNodeName(int node) const {
     if(!hasNode(node))
         throw std::invalid_argument("Provided invalid node index to get the name.");
-    return node_names.at(node);
+    if (node_name_indexes[node] < 0)
+        return std::to_string(node);
+    return std::string(names[node_name_indexes[node]]);
 }
 
-//Level Interactome::get_type(int index) {
-//    if (index <= end_indexes[genes])
-//        return genes;
-//    else if (index <= end_indexes[proteins])
-//        return proteins;
-//    else if (index <= end_indexes[proteoforms])
-//        return proteoforms;
-//    else
-//        return SimpleEntity;
-//}
-//
-//Level Interactome::get_type(std::string_view name) {
-//    return get_type(vertices.index(name.data()));
-//}
-//
-//bool Interactome::isGene(int index) {
-//    return index <= end_indexes[genes];
-//}
-//
-//bool Interactome::isProtein(int index) {
-//    return start_indexes[proteins] <= index && index <= end_indexes[proteins];
-//}
-//
-//bool Interactome::isProteoform(int index) {
-//    return start_indexes[proteoforms] <= index && index <= end_indexes[proteoforms];
-//}
-//
-//bool Interactome::isSimpleEntity(int index) {
-//    return index >= start_indexes[SimpleEntity];
-//}
-//
 //void Interactome::readEdges(std::string_view file_edges) {
 //    std::cout << "Reading edges...\n";
 //    std::ifstream f;
@@ -229,30 +289,6 @@ std::string Interactome::getNodeName(int node) const {
 //    return adj[index];
 //}
 //
-//std::set<int> Interactome::getProteinNeighbors(int index) {
-//    std::set<int> neighbors;
-//    for (auto neighbor : adj[index]) {
-//        if (isProtein(neighbor)) neighbors.insert(neighbor);
-//    }
-//    return neighbors;
-//}
-//
-//std::set<int> Interactome::getProteoformNeighbors(int index) {
-//    std::set<int> neighbors;
-//    for (auto neighbor : adj[index]) {
-//        if (isProteoform(neighbor)) neighbors.insert(neighbor);
-//    }
-//    return neighbors;
-//}
-//
-//std::set<int> Interactome::getSimpleEntityNeighbors(int index) {
-//    std::set<int> neighbors;
-//    for (auto neighbor : adj[index]) {
-//        if (isSimpleEntity(neighbor)) neighbors.insert(neighbor);
-//    }
-//    return neighbors;
-//}
-//
 //bool has(const std::vector<int> &indexes, int index) {
 //    auto lower = lower_bound(indexes.begin(), indexes.end(), index);
 //    return lower != indexes.end() && *lower == index;
@@ -278,27 +314,93 @@ std::string Interactome::getNodeName(int node) const {
 //int Interactome::getNumVertices() {
 //    return vertices.size();
 //}
-//
-//int Interactome::getStartIndexGenes() {
-//    return start_indexes[genes];
-//}
-//
-//int Interactome::getEndIndexGenes() {
-//    return end_indexes[genes];
-//}
-//
-//int Interactome::getStartIndexProteins() {
-//    return start_indexes[proteins];
-//}
-//
-//int Interactome::getEndIndexProteins() {
-//    return end_indexes[proteins];
-//}
-//
-//int Interactome::getStartIndexProteoforms() {
-//    return start_indexes[proteoforms];
-//}
-//
-//int Interactome::getEndIndexProteoforms() {
-//    return end_indexes[proteoforms];
-//}
\ No newline at end of file
+
+// Finds the boundaries of the levels in every neighbor row. A row is sorted, so they are found by binary search
+void Interactome::indexLevels() {
+    const int num_levels = getNumLevels();
+    level_boundaries.clear();
+    for (int level = 0; level < num_levels; level++) {
+        level_boundaries.push_back(start_indexes[level]);
+        level_boundaries.push_back(end_indexes[level] + 1);
+    }
+    // The ranges are sorted and do not overlap, so the only repeats are levels that end where the next starts
+    level_boundaries.erase(std::unique(level_boundaries.begin(), level_boundaries.end()), level_boundaries.end());
+    level_cuts.clear();
+    for (int level = 0; level < num_levels; level++) {
+        for (int index : {start_indexes[level], end_indexes[level] + 1})
+            level_cuts.push_back(static_cast<int>(std::lower_bound(level_boundaries.begin(), level_boundaries.end(),
+                                                                   index) - level_boundaries.begin()));
+    }
+
+    const std::size_t num_boundaries = level_boundaries.size();
+    level_offsets.assign(static_cast<std::size_t>(adj.numVertices()) * num_boundaries, 0);
+    for (int node = 0; node < adj.numVertices(); node++) {
+        const auto row = adj.getNeighbors(node);
+        int *offsets = level_offsets.data() + static_cast<std::size_t>(node) * num_boundaries;
+        auto position = row.begin();
+        for (std::size_t boundary = 0; boundary < num_boundaries; boundary++) {
+            position = std::lower_bound(position, row.end(), level_boundaries[boundary]);
+            offsets[boundary] = static_cast<int>(position - row.begin());
+        }
+    }
+}
+
+void Interactome::setLevelRanges(std::vector<int> starts, std::vector<int> ends) {
+    for (std::size_t level = 0; level < starts.size(); level++) {
+        if (starts[level] > ends[level] + 1)
+            throw std::invalid_argument("Provided inverted index range: " + std::to_string(starts[level]) + " "
+                                        + std::to_string(ends[level]));
+        if (level > 0 && starts[level] <= ends[level - 1])
+            throw std::invalid_argument("Provided overlapping or unsorted index range starting at "
+                                        + std::to_string(starts[level]));
+    }
+
+    start_indexes = std::move(starts);
+    end_indexes = std::move(ends);
+    indexLevels();
+}
+
+void Interactome::readTypeRanges(std::istream &s) {
+    std::vector<int> starts_read, ends_read;
+    int start_index, end_index;
+    while (s >> start_index >> end_index) {
+        starts_read.push_back(start_index);
+        ends_read.push_back(end_index);
+    }
+    setLevelRanges(std::move(starts_read), std::move(ends_read));
+}
+
+int Interactome::getStartIndex(Level level) const {
+    if (level >= getNumLevels())
+        throw std::out_of_range("There is no index range for level " + LEVELS[level]);
+    return start_indexes[level];
+}
+
+int Interactome::getEndIndex(Level level) const {
+    if (level >= getNumLevels())
+        throw std::out_of_range("There is no index range for level " + LEVELS[level]);
+    return end_indexes[level];
+}
+
+Level Interactome::get_type(int index) const {
+    for (int level = 0; level < getNumLevels(); level++)
+        if (start_indexes[level] <= index && index <= end_indexes[level])
+            return static_cast<Level>(level);
+    throw std::out_of_range("The node " + std::to_string(index) + " is not in any level range.");
+}
+
+Level Interactome::get_type(std::string_view name) const {
+    int index = getNodeIndex(name);
+    if (index < 0)
+        throw std::invalid_argument("Provided unexistent node name: " + std::string(name));
+    return get_type(index);
+}
+
+std::span<const int> Interactome::getInteractors(int node, Level level) const {
+    const auto row = getInteractors(node);
+    if (level >= getNumLevels())
+        throw std::out_of_range("There is no index range for level " + LEVELS[level]);
+    const int *offsets = level_offsets.data() + static_cast<std::size_t>(node) * level_boundaries.size();
+    const int first = offsets[level_cuts[2 * level]], end = offsets[level_cuts[2 * level + 1]];
+    return row.subspan(first, end - first);
+}
@@ -2,10 +2,15 @@
 #define PROTEOFORMNETWORKS_INTERACTOME_HPP
 
 #include <string_view>
+#include <functional>
 #include <map>
+#include <span>
 #include <vector>
 #include <set>
 #include "bimap_str_int.hpp"
+#include "csr.hpp"
+#include "interactome_snapshot.hpp"
+#include "name_table.hpp"
 #include "types.hpp"
 #include <fstream>
 #include <iostream>
@@ -18,14 +23,39 @@
 // Each entity type has a range of indexes [x, y], where all possible indexes between x and y inclusive are entities
 // of the said type.
 // First are the genes, then proteins, then proteoforms, then small molecules.
+// The interactions are kept frozen in compressed sparse row format: added nodes and interactions are staged and the
+// adjacency is rebuilt once by finalize(), reading neighbors only returns views into it.
 class Interactome {
 
-    std::map<std::string, int> node_indexes;
-    std::vector<std::string> node_names;
-    std::vector<std::set<int>> adj_list;
-//
-//    std::vector<int> start_indexes;
-//    std::vector<int> end_indexes;
+    NameTable names;
+    std::vector<int> node_name_indexes;     // Index in names of the name of each node, or -1 for the default name
+    std::vector<int> name_nodes;            // Node of each name in names
+    std::vector<bool> node_present;
+    CSRAdjacency adj;
+    std::vector<std::pair<int, int>> pending_interactions;     // Added since the last finalize()
+
+    std::vector<int> start_indexes;
+    std::vector<int> end_indexes;
+
+    // The boundaries of the levels: every start index and every end index + 1, sorted and without repeats, so L
+    // contiguous levels have L + 1 boundaries. Level l goes from boundary level_cuts[2l] to level_cuts[2l + 1].
+    std::vector<int> level_boundaries;
+    std::vector<int> level_cuts;
+
+    // For node v and boundary b, level_offsets[v * B + b] is the position in adj.getNeighbors(v) of the first
+    // neighbor with an index of at least level_boundaries[b], with B boundaries. The neighbors are sorted by index
+    // and the levels are index ranges, so each level is a slice between two of these positions.
+    std::vector<int> level_offsets;
+
+    void markNode(int index);
+
+    void indexLevels();
+
+    // Sets the level ranges and indexes them. Throws std::invalid_argument if a range is inverted, or if the ranges
+    // are unsorted or overlap, since the level slices of the neighbors depend on sorted ranges.
+    void setLevelRanges(std::vector<int> starts, std::vector<int> ends);
+
+    void checkFinalized() const;
 //
 //    void readRanges(std::string_view file_interactions);
 //
@@ -43,7 +73,23 @@ public:
 
     Interactome();
 
-    void addInteractions(std::vector<std::pair<int, int>> &interactions);
+    explicit Interactome(const std::vector<std::pair<int, int>> &interactions);
+
+    // Loads names and ranges from the snapshot and reads the interactions directly from its mapped pages.
+    explicit Interactome(const InteractomeSnapshot &snapshot);
+
+    void writeSnapshot(std::string_view file_snapshot) const;
+
+    // Adds the nodes and stages the interactions until finalize().
+    void addInteractions(const std::vector<std::pair<int, int>> &interactions);
+
+    // Rebuilds the compressed adjacency once with the previous and the staged nodes and interactions, in
+    // O((V + E) log E). Reading the interactions with changes pending throws std::logic_error.
+    void finalize();
+
+    [[nodiscard]] bool hasPendingChanges() const {
+        return !pending_interactions.empty() || static_cast<int>(node_present.size()) > adj.numVertices();
+    }
 
     std::vector<int> getNodes() const;
 
@@ -55,49 +101,100 @@ public:
 //    int index(std::string_view name);
 //
 
-//
-//    Level get_type(int index);
-//
-//    Level get_type(std::string_view name);
-//
-//    bool isGene(int index);
-//
-//    bool isProtein(int index);
-//
-//    bool isProteoform(int index);
-//
-//    bool isSimpleEntity(int index);
-//
 //    std::vector<int> getProteins(int gene_index);
 //
 //    std::vector<int> getProteoforms(int protein_index);
 //
 //    std::set<int> getNeighbors(int index);
 //
-//    std::set<int> getSimpleEntityNeighbors(int index);
-//
-//    std::set<int> getProteinNeighbors(int index);
-//
-//    std::set<int> getProteoformNeighbors(int index);
-//
 //    std::vector<std::pair<int, int>> getInteractions(std::vector<int> indexes);
 //
 //    int getNumVertices();
-//
-//    int getStartIndexGenes();
-//    int getEndIndexGenes();
-//    int getStartIndexProteins();
-//    int getEndIndexProteins();
-//    int getStartIndexProteoforms();
-//    int getEndIndexProteoforms();
 
+    // Reads one "start end" pair of inclusive node indexes per level, in the order of Level. The ranges must be
+    // sorted and must not overlap.
+    void readTypeRanges(std::istream &s);
+
+    [[nodiscard]] int getNumLevels() const { return static_cast<int>(start_indexes.size()); }
+
+    [[nodiscard]] int getStartIndex(Level level) const;
+
+    [[nodiscard]] int getEndIndex(Level level) const;
+
+    [[nodiscard]] int getStartIndexGenes() const { return getStartIndex(genes); }
+    [[nodiscard]] int getEndIndexGenes() const { return getEndIndex(genes); }
+    [[nodiscard]] int getStartIndexProteins() const { return getStartIndex(proteins); }
+    [[nodiscard]] int getEndIndexProteins() const { return getEndIndex(proteins); }
+    [[nodiscard]] int getStartIndexProteoforms() const { return getStartIndex(proteoforms); }
+    [[nodiscard]] int getEndIndexProteoforms() const { return getEndIndex(proteoforms); }
+
+    // Level of the node. Throws std::out_of_range for nodes outside all the ranges.
+    [[nodiscard]] Level get_type(int index) const;
+
+    [[nodiscard]] Level get_type(std::string_view name) const;
+
+    [[nodiscard]] bool isGene(int index) const { return isInLevel(index, genes); }
+
+    [[nodiscard]] bool isProtein(int index) const { return isInLevel(index, proteins); }
+
+    [[nodiscard]] bool isProteoform(int index) const { return isInLevel(index, proteoforms); }
+
+    [[nodiscard]] bool isSimpleEntity(int index) const { return isInLevel(index, SimpleEntity); }
+
+    [[nodiscard]] bool isInLevel(int index, Level level) const {
+        return level < getNumLevels() && start_indexes[level] <= index && index <= end_indexes[level];
+    }
+
+    // Sorted neighbors of the node that belong to the level, as a slice of getInteractors(node).
+    [[nodiscard]] std::span<const int> getInteractors(int node, Level level) const;
+
+    [[nodiscard]] std::span<const int> getSimpleEntityNeighbors(int index) const {
+        return getInteractors(index, SimpleEntity);
+    }
+
+    [[nodiscard]] std::span<const int> getProteinNeighbors(int index) const { return getInteractors(index, proteins); }
+
+    [[nodiscard]] std::span<const int> getProteoformNeighbors(int index) const {
+        return getInteractors(index, proteoforms);
+    }
+
+    // Adds the node without interactions. A node past the last vertex of the adjacency is staged until finalize(),
+    // which then copies the offsets once, so add all the nodes before finalizing.
     void addNode(int index);
 
-    [[nodiscard]] std::vector<int> getInteractors(int node) const;
+    // Sorted neighbors of the node. The view is valid until the interactome is modified.
+    [[nodiscard]] std::span<const int> getInteractors(int node) const;
+
+    [[nodiscard]] const CSRAdjacency &getAdjacency() const {
+        checkFinalized();
+        return adj;
+    }
+
+    // Interactions between the nodes first_node + i for every bit i set in members.
+    [[nodiscard]] InducedSubgraph getInducedSubgraph(const base::dynamic_bitset<> &members, int first_node = 0) const {
+        return getAdjacency().getInducedSubgraph(members, first_node);
+    }
+
+    [[nodiscard]] std::vector<InducedSubgraph> getInducedSubgraphs(const vb &members, int first_node = 0,
+                                                                   int num_threads = 0) const {
+        return getAdjacency().getInducedSubgraphs(members, first_node, num_threads);
+    }
+
+    [[nodiscard]] InducedSubgraph getInducedSubgraph(const HybridSet &members, int first_node = 0) const {
+        return getAdjacency().getInducedSubgraph(members, first_node);
+    }
+
+    [[nodiscard]] std::vector<InducedSubgraph> getInducedSubgraphs(const std::vector<HybridSet> &members,
+                                                                   int first_node = 0, int num_threads = 0) const {
+        return getAdjacency().getInducedSubgraphs(members, first_node, num_threads);
+    }
 
     [[nodiscard]] bool hasNode(int node) const;
     [[nodiscard]] bool hasNode(std::string_view name) const;
 
+    // Index of the node with the name, or -1 when there is no such node.
+    [[nodiscard]] int getNodeIndex(std::string_view name) const;
+
     void readNodeNames(std::istream &s);
 };
 
@@ -1,4 +1,7 @@
+#include <cctype>
 #include "bimap_str_int.hpp"
+#include "parallel.hpp"
+#include "string_sort.hpp"
 
 Bimap_str_int::Bimap_str_int() {
 
@@ -34,12 +37,9 @@ Bimap_str_int::Bimap_str_int(std::string_view file_elements) {
     }
 
     std::string element;
-    int i = 0;
     while (f >> element) {
 //        std::cout << "Adding element: " << element << std::endl;
-        itos.push_back(element);
-        stoi[element] = i;
-        i++;
+        names.intern(element);
     }
     std::cout << "Complete.\n\n";
 }
@@ -49,9 +49,11 @@ Bimap_str_int::Bimap_str_int(std::string_view file_elements) {
 // Creates a bimap of the elements in the selected column.
 // Column index starts counting at 0
 // The columns of the file must be separated by a tab ('\t')
-Bimap_str_int::Bimap_str_int(std::string_view file_elements, bool has_header, int column_index, int total_num_columns) :
-        itos{createIntToStr(file_elements, has_header, column_index, total_num_columns)},
-        stoi{createStrToInt(itos)} {
+Bimap_str_int::Bimap_str_int(std::string_view file_elements, bool has_header, int column_index, int total_num_columns) {
+    MappedFile file(file_elements);
+    std::vector<std::string_view> entities = readColumn(file, has_header, column_index, total_num_columns);
+    sortUnique(entities);
+    internSorted(entities);
 }
 
 
@@ -67,65 +69,89 @@ umsi createStrToInt(const vs &index_to_entities) {
 // Removes the duplicate elements in the vector
 // Sorts the elements to assign the indexes
 Bimap_str_int::Bimap_str_int(const vs &index_to_entities) {
-    std::set<std::string> s(index_to_entities.begin(), index_to_entities.end());
-    vs sortedAndUniqueVector(s.begin(), s.end());
-    itos = sortedAndUniqueVector;
-    stoi = createStrToInt(sortedAndUniqueVector);
+    std::vector<std::string_view> entities(index_to_entities.begin(), index_to_entities.end());
+    sortUnique(entities);
+    internSorted(entities);
 }
 
-int Bimap_str_int::index(const std::string &key) const {
-    if(stoi.find(key) == stoi.end())
-    {
-//        std::cerr << "Key not found: " << key << std::endl;
-        return -1;
-    }
-    return stoi.at(key);
+void Bimap_str_int::internSorted(const std::vector<std::string_view> &sorted_entities) {
+    std::size_t num_characters = 0;
+    for (auto entity : sorted_entities)
+        num_characters += entity.size();
+    names.reserve(sorted_entities.size(), num_characters);
+    for (auto entity : sorted_entities)
+        names.intern(entity);
 }
 
 // The input file has one identifier per row in the selected column.
 // The index of the selected column starts counting at 0.
-vs createIntToStr(std::string_view path_file, bool has_header, int selected_column, int total_num_columns) {
-    std::ifstream map_file(path_file.data());
-    std::string entity, leftover;
-    uss temp_set;
-    vs index_to_entities;
-    int current_column;
-
-    if (!map_file.is_open()) {
-        std::string message = "Could not open file ";
-        message += path_file;
-        message += " at ";
-        message += __FUNCTION__;
-        throw std::runtime_error(message);
-    }
+vs createIntToStr(std::string_view path_file, bool has_header, int selected_column, int total_num_columns,
+                  int num_threads) {
+    MappedFile file(path_file);
+    std::vector<std::string_view> entities = readColumn(file, has_header, selected_column, total_num_columns,
+                                                        num_threads);
+    sortUnique(entities, num_threads);
+    return vs(entities.begin(), entities.end());
+}
 
+// The file is split in chunks of about the same size that start after a line break. Each chunk is a task that
+// collects the views of the lines starting in it.
+std::vector<std::string_view> readColumn(const MappedFile &file, bool has_header, int selected_column,
+                                         int total_num_columns, int num_threads) {
     if (selected_column >= total_num_columns || selected_column < 0) {
         throw std::runtime_error("Invalid column index");
     }
-
-    if (has_header) {
-        getline(map_file, leftover);  // Skip header line
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+
+    const char *begin = reinterpret_cast<const char *>(file.data());
+    const char *end = begin + file.size();
+    if (has_header && begin < end) {   // Skip header line
+        auto newline = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+        begin = newline ? newline + 1 : end;
     }
 
-    current_column = 0;
-    while (map_file.peek() != EOF) {
-        while (current_column != selected_column) {
-            std::getline(map_file, leftover, '\t');
-            current_column++;
-        }
-        if (selected_column == total_num_columns - 1) {
-            std::getline(map_file, entity, '\n');
-        } else {
-            std::getline(map_file, entity, '\t');
-            std::getline(map_file, leftover, '\n');
+    auto line_start_after = [&](const char *position) {
+        if (position <= begin)
+            return begin;
+        auto newline = static_cast<const char *>(std::memchr(position - 1, '\n', end - position + 1));
+        return newline ? newline + 1 : end;
+    };
+
+    const std::size_t num_chunks = static_cast<std::size_t>(num_threads) * 4;
+    std::vector<std::vector<std::string_view>> chunk_entities(num_chunks);
+    parallelFor(num_chunks, [&](std::size_t chunk, int) {
+        const char *position = line_start_after(begin + (end - begin) * chunk / num_chunks);
+        const char *chunk_end = line_start_after(begin + (end - begin) * (chunk + 1) / num_chunks);
+        auto &entities = chunk_entities[chunk];
+
+        while (position < chunk_end) {
+            auto newline = static_cast<const char *>(std::memchr(position, '\n', chunk_end - position));
+            const char *line_end = newline ? newline : chunk_end;
+            const char *next = newline ? newline + 1 : chunk_end;
+            if (line_end > position && line_end[-1] == '\r')
+                line_end--;
+            const char *field = position;
+            for (int column = 0; column < selected_column && field < line_end; column++) {
+                auto tab = static_cast<const char *>(std::memchr(field, '\t', line_end - field));
+                field = tab ? tab + 1 : line_end;
+            }
+            auto tab = static_cast<const char *>(std::memchr(field, '\t', line_end - field));
+            const char *field_end = tab ? tab : line_end;
+            while (field_end > field && std::isspace(static_cast<unsigned char>(field_end[-1])))
+                field_end--;
+            if (line_end > position)    // Blank lines have no entity
+                entities.emplace_back(field, field_end - field);
+            position = next;
         }
-        temp_set.insert(rtrim(entity));
-        current_column = 0;
-    }
-    index_to_entities = convert_uss_to_vs(temp_set);
-    sort(index_to_entities.begin(), index_to_entities.end());
-
-    return index_to_entities;
+    }, num_threads);
+
+    std::size_t num_entities = 0;
+    for (const auto &entities : chunk_entities)
+        num_entities += entities.size();
+    std::vector<std::string_view> result;
+    result.reserve(num_entities);
+    for (const auto &entities : chunk_entities)
+        result.insert(result.end(), entities.begin(), entities.end());
+    return result;
 }
-
-
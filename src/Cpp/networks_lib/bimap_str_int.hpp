@@ -6,6 +6,8 @@
 #include <string_view>
 #include <cstring>
 #include <set>
+#include "mapped_file.hpp"
+#include "name_table.hpp"
 #include "types.hpp"
 #include <iostream>
 
@@ -13,15 +15,23 @@ std::string rtrim(std::string &s);
 
 vs convert_uss_to_vs(const uss &a_set);
 
-vs createIntToStr(std::string_view path_file, bool has_header = true, int column_index = 0, int total_num_columns = 1);
+vs createIntToStr(std::string_view path_file, bool has_header = true, int column_index = 0, int total_num_columns = 1,
+                  int num_threads = 0);
+
+// Views of the selected column of every row of a tab separated file, without trailing whitespace and in file order.
+// The rows are parsed in parallel chunks; the views point into the mapped file.
+std::vector<std::string_view> readColumn(const MappedFile &file, bool has_header = true, int column_index = 0,
+                                         int total_num_columns = 1, int num_threads = 0);
 
 umsi createStrToInt(const vs &index_to_entities);
 
+// The names are stored once in an interning table: the index of a name is its position in the table.
 class Bimap_str_int {
 
-    umsi stoi; // string to int
+    NameTable names;
 
-    vs itos; // int to string
+    // Interns sorted unique entities, so the index of each one is its position
+    void internSorted(const std::vector<std::string_view> &sorted_entities);
 
 public:
 
@@ -37,13 +47,18 @@ public:
 
     Bimap_str_int(const vs &index_to_entities);
 
-    int size() const { return itos.size(); }
+    // Optional step once the bimap is built: lookups by name then take one slot read and one comparison.
+    bool buildPerfectHash() { return names.buildPerfectHash(); }
+
+    int size() const { return names.size(); }
 
-    bool has(const std::string &key) const { return stoi.find(key) != stoi.end(); };
+    bool has(std::string_view key) const { return names.contains(key); };
 
-    int index(const std::string &key) const;
+    // Index of the key, or -1 when it is not in the bimap.
+    int index(std::string_view key) const { return names.find(key); }
 
-    std::string name(const int index) const { return itos[index]; };
+    // The view is valid while the bimap lives.
+    std::string_view name(const int index) const { return names[index]; };
 
 };
 
@@ -0,0 +1,69 @@
+#include <stdexcept>
+#include <string>
+#include "bit_matrix.hpp"
+
+BitMatrix::BitMatrix(const vb &sets) :
+        num_rows(sets.size()),
+        padded_rows((sets.size() + TILE_ROWS - 1) / TILE_ROWS * TILE_ROWS),
+        num_columns(sets.empty() ? 0 : sets.front().size()),
+        num_panels((num_columns + PANEL_WORDS * 64 - 1) / (PANEL_WORDS * 64)),
+        cardinalities(sets.size()) {
+
+    const std::size_t num_words = std::max<std::size_t>(num_panels * padded_rows * PANEL_WORDS, 1);
+    words.reset(new(std::align_val_t(base::cacheline_byte_size)) word_type[num_words]());
+
+    using block_type = base::dynamic_bitset<>::block_type;
+    constexpr std::size_t BLOCK_BITS = base::bit_size<block_type>();
+    for (std::size_t row = 0; row < num_rows; row++) {
+        if (sets[row].size() != num_columns)
+            throw std::invalid_argument("The set " + std::to_string(row) + " has " + std::to_string(sets[row].size())
+                                        + " bits, but the matrix has " + std::to_string(num_columns) + " columns.");
+        const block_type *blocks = sets[row].block_begin();
+        for (std::size_t block = 0; block < sets[row].blocks(); block++) {
+            const std::size_t bit = block * BLOCK_BITS;
+            const std::size_t word = bit / 64;
+            panelRow(word / PANEL_WORDS, row)[word % PANEL_WORDS]
+                    |= static_cast<word_type>(blocks[block]) << (bit % 64);
+        }
+        cardinalities[row] = sets[row].count();
+    }
+}
+
+void BitMatrix::countTile(std::size_t first_row1, std::size_t first_row2, std::uint32_t *counts) const {
+    for (std::size_t panel = 0; panel < num_panels; panel++) {
+        for (std::size_t row1 = 0; row1 < TILE_ROWS; row1 += MICRO_ROWS) {
+            // The tiles in the diagonal only need the upper triangle of micro tiles
+            const std::size_t start_row2 = first_row1 == first_row2 ? row1 : 0;
+            const word_type *a[MICRO_ROWS];
+            for (std::size_t i = 0; i < MICRO_ROWS; i++)
+                a[i] = panelRow(panel, first_row1 + row1 + i);
+
+            for (std::size_t row2 = start_row2; row2 < TILE_ROWS; row2 += MICRO_ROWS) {
+                const word_type *b[MICRO_ROWS];
+                for (std::size_t j = 0; j < MICRO_ROWS; j++)
+                    b[j] = panelRow(panel, first_row2 + row2 + j);
+
+                std::uint32_t accumulators[MICRO_ROWS][MICRO_ROWS] = {};
+                for (std::size_t word = 0; word < PANEL_WORDS; word++)
+                    for (std::size_t i = 0; i < MICRO_ROWS; i++)
+                        for (std::size_t j = 0; j < MICRO_ROWS; j++)
+                            accumulators[i][j] += std::popcount(a[i][word] & b[j][word]);
+
+                for (std::size_t i = 0; i < MICRO_ROWS; i++)
+                    for (std::size_t j = 0; j < MICRO_ROWS; j++)
+                        counts[(row1 + i) * TILE_ROWS + row2 + j] += accumulators[i][j];
+            }
+        }
+    }
+}
+
+std::vector<std::uint32_t> BitMatrix::countIntersections(int num_threads) const {
+    std::vector<std::uint32_t> result(num_rows * num_rows, 0);
+    for (std::size_t row = 0; row < num_rows; row++)
+        result[row * num_rows + row] = static_cast<std::uint32_t>(cardinalities[row]);
+    forEachIntersection([&](std::size_t row1, std::size_t row2, std::uint32_t count, int) {
+        result[row1 * num_rows + row2] = count;
+        result[row2 * num_rows + row1] = count;
+    }, num_threads);
+    return result;
+}
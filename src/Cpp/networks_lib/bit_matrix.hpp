@@ -0,0 +1,133 @@
+#ifndef PROTEOFORMNETWORKS_BIT_MATRIX_HPP
+#define PROTEOFORMNETWORKS_BIT_MATRIX_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+#include "../base/memory.h"
+#include "overlap_types.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
+#include "types.hpp"
+
+// Module x entity bit matrix for all-pairs intersection counts, packed like the operands of a matrix product.
+// The entity columns are split in panels of PANEL_WORDS 64-bit words. The slices of all the rows in a panel are
+// stored together, row after row, in cache line aligned memory. The counts are computed like a GEMM with AND as the
+// product and popcount as the sum: the pair matrix is split in tiles of TILE_ROWS x TILE_ROWS modules, and for each
+// panel a micro kernel accumulates MICRO_ROWS x MICRO_ROWS counts in registers while both tiles stay in L1.
+class BitMatrix {
+
+public:
+
+    using word_type = std::uint64_t;
+
+    static constexpr std::size_t TILE_ROWS = 64;
+    static constexpr std::size_t MICRO_ROWS = 4;
+    // The panels of the two tiles of a task fill half of the L1 cache
+    static constexpr std::size_t PANEL_WORDS = std::max<std::size_t>(
+            base::cacheline_byte_size / sizeof(word_type),
+            base::l1_cache_byte_size / (4 * TILE_ROWS * sizeof(word_type)));
+
+private:
+
+    struct AlignedDelete {
+        void operator()(word_type *words) const {
+            ::operator delete[](words, std::align_val_t(base::cacheline_byte_size));
+        }
+    };
+
+    std::size_t num_rows;
+    std::size_t padded_rows;           // Multiple of TILE_ROWS, the extra rows are empty
+    std::size_t num_columns;
+    std::size_t num_panels;
+    std::unique_ptr<word_type[], AlignedDelete> words;
+    std::vector<std::size_t> cardinalities;
+
+    [[nodiscard]] const word_type *panelRow(std::size_t panel, std::size_t row) const {
+        return words.get() + (panel * padded_rows + row) * PANEL_WORDS;
+    }
+
+    word_type *panelRow(std::size_t panel, std::size_t row) {
+        return words.get() + (panel * padded_rows + row) * PANEL_WORDS;
+    }
+
+    // Adds to counts[i * TILE_ROWS + j] the intersections of the rows first_row1 + i and first_row2 + j
+    void countTile(std::size_t first_row1, std::size_t first_row2, std::uint32_t *counts) const;
+
+public:
+
+    // All the sets must have the same size, which is the number of columns.
+    // Throws std::invalid_argument when they do not.
+    explicit BitMatrix(const vb &sets);
+
+    [[nodiscard]] std::size_t rows() const { return num_rows; }
+
+    [[nodiscard]] std::size_t columns() const { return num_columns; }
+
+    [[nodiscard]] std::size_t cardinality(std::size_t row) const { return cardinalities[row]; }
+
+    [[nodiscard]] bool get(std::size_t row, std::size_t column) const {
+        const word_type word = panelRow(column / (PANEL_WORDS * 64), row)[column / 64 % PANEL_WORDS];
+        return (word >> (column % 64)) & 1u;
+    }
+
+    // Calls f(row1, row2, intersection_count, worker) for every pair row1 < row2. The upper triangle of tiles is
+    // counted in parallel by num_threads workers (0 uses all hardware threads).
+    template<typename F>
+    void forEachIntersection(F &&f, int num_threads = 0) const {
+        const std::size_t num_tiles = padded_rows / TILE_ROWS;
+        std::vector<std::pair<std::size_t, std::size_t>> tiles;
+        for (std::size_t tile1 = 0; tile1 < num_tiles; tile1++)
+            for (std::size_t tile2 = tile1; tile2 < num_tiles; tile2++)
+                tiles.emplace_back(tile1, tile2);
+
+        parallelFor(tiles.size(), [&](std::size_t tile, int worker) {
+            const std::size_t first_row1 = tiles[tile].first * TILE_ROWS, first_row2 = tiles[tile].second * TILE_ROWS;
+            std::vector<std::uint32_t> counts(TILE_ROWS * TILE_ROWS, 0);
+            countTile(first_row1, first_row2, counts.data());
+            const std::size_t end_row1 = std::min(first_row1 + TILE_ROWS, num_rows);
+            const std::size_t end_row2 = std::min(first_row2 + TILE_ROWS, num_rows);
+            for (std::size_t row1 = first_row1; row1 < end_row1; row1++)
+                for (std::size_t row2 = std::max(first_row2, row1 + 1); row2 < end_row2; row2++)
+                    f(row1, row2, counts[(row1 - first_row1) * TILE_ROWS + row2 - first_row2], worker);
+        }, num_threads);
+    }
+
+    // Full symmetric rows() x rows() matrix of intersection counts, row major, with the cardinalities in the diagonal.
+    [[nodiscard]] std::vector<std::uint32_t> countIntersections(int num_threads = 0) const;
+};
+
+// Calculate score between all pairs of rows of the bit matrix, with the counts of the blocked AND and popcount
+// kernel. The score is called with the overlap counts of every pair of modules within the sizes, so it matches the
+// all-pairs getScores for any score.
+// Returns only the sets within the module sizes and with a score greater than 0.
+template<typename R = pair_map<double>, typename S>
+R getScores(const BitMatrix &matrix, S score_function,
+            const int min_module_size, const int max_module_size, int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(matrix.rows(), 1).finish();
+    std::vector<char> is_selected(matrix.rows());
+    for (std::size_t row = 0; row < matrix.rows(); row++)
+        is_selected[row] = static_cast<std::size_t>(std::max(min_module_size, 0)) <= matrix.cardinality(row)
+                           && matrix.cardinality(row) <= static_cast<std::size_t>(max_module_size);
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<R> collector(matrix.rows(), num_threads);
+    matrix.forEachIntersection([&](std::size_t row1, std::size_t row2, std::uint32_t count, int worker) {
+        if (!is_selected[row1] || !is_selected[row2])
+            return;
+        const double score = score_function(base::overlap_count{matrix.cardinality(row1), matrix.cardinality(row2),
+                                                                count});
+        if (score > 0)
+            collector.store(worker, static_cast<int>(row1), static_cast<int>(row2), score);
+    }, num_threads);
+
+    return collector.finish();
+}
+
+#endif //PROTEOFORMNETWORKS_BIT_MATRIX_HPP
@@ -0,0 +1,42 @@
+#include "crosstalk.hpp"
+
+CrosstalkMatrix::CrosstalkMatrix(const vb &sets, const CSRAdjacency &adjacency, int first_vertex) :
+        num_modules(sets.size()),
+        module_offsets(sets.size() + 1, 0) {
+
+    const int num_vertices = sets.empty() ? 0 : static_cast<int>(sets.front().size());
+
+    // Module -> members, and the number of modules of each vertex
+    std::vector<int> num_vertex_modules(num_vertices, 0);
+    for (std::size_t module = 0; module < sets.size(); module++) {
+        sets[module].visit_set([&](auto member) {
+            module_members.push_back(static_cast<int>(member));
+            num_vertex_modules[member]++;
+        });
+        module_offsets[module + 1] = static_cast<int>(module_members.size());
+    }
+
+    // Vertex -> modules, filled module after module so the modules of each vertex are sorted
+    vertex_offsets.assign(num_vertices + 1, 0);
+    for (int vertex = 0; vertex < num_vertices; vertex++)
+        vertex_offsets[vertex + 1] = vertex_offsets[vertex] + num_vertex_modules[vertex];
+    vertex_modules.resize(module_members.size());
+    std::vector<int> next(vertex_offsets.begin(), vertex_offsets.end() - 1);
+    for (std::size_t module = 0; module < num_modules; module++)
+        for (int J = module_offsets[module]; J < module_offsets[module + 1]; J++)
+            vertex_modules[next[module_members[J]]++] = static_cast<int>(module);
+
+    // Adjacency of the level, only for members and only to members
+    neighbor_offsets.assign(num_vertices + 1, 0);
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+        const int node = first_vertex + vertex;
+        if (num_vertex_modules[vertex] > 0 && 0 <= node && node < adjacency.numVertices()) {
+            for (int neighbor : adjacency.getNeighbors(node)) {
+                const int local = neighbor - first_vertex;
+                if (0 <= local && local < num_vertices && num_vertex_modules[local] > 0)
+                    neighbors.push_back(local);
+            }
+        }
+        neighbor_offsets[vertex + 1] = static_cast<int>(neighbors.size());
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef PROTEOFORMNETWORKS_CROSSTALK_HPP
+#define PROTEOFORMNETWORKS_CROSSTALK_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "csr.hpp"
+#include "overlap_types.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
+#include "types.hpp"
+
+// Edge counts between all pairs of modules of one level, as the sparse product C = Mᵀ A M of the vertex x module
+// membership matrix M and the adjacency A of the level.
+// C[m1][m2] is the number of adjacency entries (u, v) with u in m1 and v in m2: an edge between a member of only m1
+// and a member of only m2 counts once, an edge with both ends in both modules counts twice.
+// M is kept in compressed rows both ways, module -> members and vertex -> modules. A keeps only the neighbors inside
+// the level that belong to some module, so vertices outside all modules cost nothing in the product.
+// The sets are bitsets over the level, where bit i is the vertex first_vertex + i of the adjacency.
+class CrosstalkMatrix {
+
+    std::size_t num_modules;
+    std::vector<int> module_offsets;     // Members of module m in module_members[module_offsets[m], module_offsets[m + 1])
+    std::vector<int> module_members;
+    std::vector<int> vertex_offsets;     // Modules of vertex v in vertex_modules[vertex_offsets[v], vertex_offsets[v + 1])
+    std::vector<int> vertex_modules;
+    std::vector<int> neighbor_offsets;   // Neighbors of vertex v in neighbors[neighbor_offsets[v], neighbor_offsets[v + 1])
+    std::vector<int> neighbors;
+
+public:
+
+    CrosstalkMatrix(const vb &sets, const CSRAdjacency &adjacency, int first_vertex = 0);
+
+    [[nodiscard]] std::size_t size() const { return num_modules; }
+
+    [[nodiscard]] std::size_t numMembers(std::size_t module) const {
+        return module_offsets[module + 1] - module_offsets[module];
+    }
+
+    // Calls f(module1, module2, count, worker) for every pair module1 < module2 with a non-zero count. Each task is
+    // one row of C, computed with a dense accumulator per worker (Gustavson's algorithm) by num_threads workers
+    // (0 uses all hardware threads). The calls of one row are in increasing order of module2.
+    template<typename F>
+    void forEachCrosstalk(F &&f, int num_threads = 0) const {
+        if (num_threads <= 0)
+            num_threads = defaultNumThreads();
+        std::vector<std::vector<std::uint32_t>> counts(num_threads);
+        std::vector<std::vector<int>> touched(num_threads);
+
+        parallelFor(num_modules, [&](std::size_t module1, int worker) {
+            auto &row = counts[worker];
+            auto &columns = touched[worker];
+            if (row.empty())
+                row.assign(num_modules, 0);
+            for (int J = module_offsets[module1]; J < module_offsets[module1 + 1]; J++) {
+                const int member = module_members[J];
+                for (int K = neighbor_offsets[member]; K < neighbor_offsets[member + 1]; K++) {
+                    const int neighbor = neighbors[K];
+                    // The modules of a vertex are sorted, so the ones after module1 are a suffix
+                    const int *first = vertex_modules.data() + vertex_offsets[neighbor];
+                    const int *last = vertex_modules.data() + vertex_offsets[neighbor + 1];
+                    for (auto module2 = std::upper_bound(first, last, static_cast<int>(module1)); module2 < last;
+                         module2++) {
+                        if (row[*module2]++ == 0)
+                            columns.push_back(*module2);
+                    }
+                }
+            }
+            std::sort(columns.begin(), columns.end());
+            for (int module2 : columns) {
+                f(module1, static_cast<std::size_t>(module2), row[module2], worker);
+                row[module2] = 0;
+            }
+            columns.clear();
+        }, num_threads);
+    }
+};
+
+// Number of edges between every pair of modules within the sizes, from the sparse product of the crosstalk matrix.
+// Returns only the pairs with some edge between them.
+template<typename R = pair_map<double>>
+R getScores(const CrosstalkMatrix &crosstalk, const int min_module_size, const int max_module_size,
+            int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(crosstalk.size(), 1).finish();
+    std::vector<char> is_selected(crosstalk.size());
+    for (std::size_t module = 0; module < crosstalk.size(); module++)
+        is_selected[module] = static_cast<std::size_t>(std::max(min_module_size, 0)) <= crosstalk.numMembers(module)
+                              && crosstalk.numMembers(module) <= static_cast<std::size_t>(max_module_size);
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<R> collector(crosstalk.size(), num_threads);
+    crosstalk.forEachCrosstalk([&](std::size_t module1, std::size_t module2, std::uint32_t count, int worker) {
+        if (is_selected[module1] && is_selected[module2])
+            collector.store(worker, static_cast<int>(module1), static_cast<int>(module2), count);
+    }, num_threads);
+
+    return collector.finish();
+}
+
+#endif //PROTEOFORMNETWORKS_CROSSTALK_HPP
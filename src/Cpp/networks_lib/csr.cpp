@@ -0,0 +1,164 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "csr.hpp"
+#include "parallel.hpp"
+
+// The vectors are moved into one shared block and the spans point into it
+void CSRAdjacency::adopt(std::vector<int> &&new_offsets, std::vector<int> &&new_neighbors) {
+    auto arrays = std::make_shared<std::pair<std::vector<int>, std::vector<int>>>(std::move(new_offsets),
+                                                                                 std::move(new_neighbors));
+    offsets = arrays->first;
+    neighbors = arrays->second;
+    storage = std::move(arrays);
+}
+
+CSRAdjacency::CSRAdjacency() {
+    adopt(std::vector<int>(1, 0), {});
+}
+
+CSRAdjacency::CSRAdjacency(std::shared_ptr<const void> storage, std::span<const int> offsets,
+                           std::span<const int> neighbors) :
+        storage(std::move(storage)), offsets(offsets), neighbors(neighbors) {
+    if (offsets.empty() || static_cast<std::size_t>(offsets.back()) != neighbors.size())
+        throw std::invalid_argument("The offsets do not match the number of neighbor entries.");
+}
+
+CSRAdjacency::CSRAdjacency(int num_vertices, const std::vector<std::pair<int, int>> &edges) {
+    std::vector<int> offsets(num_vertices + 1, 0);
+
+    // Count the entries of each row, then place them with a counting sort
+    for (const auto &edge : edges) {
+        if (edge.first < 0 || edge.first >= num_vertices || edge.second < 0 || edge.second >= num_vertices)
+            throw std::out_of_range("Edge (" + std::to_string(edge.first) + ", " + std::to_string(edge.second)
+                                    + ") is outside the vertex range.");
+        offsets[edge.first + 1]++;
+        if (edge.first != edge.second)
+            offsets[edge.second + 1]++;
+    }
+    for (int vertex = 0; vertex < num_vertices; vertex++)
+        offsets[vertex + 1] += offsets[vertex];
+
+    std::vector<int> neighbors(offsets[num_vertices]);
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (const auto &edge : edges) {
+        neighbors[next[edge.first]++] = edge.second;
+        if (edge.first != edge.second)
+            neighbors[next[edge.second]++] = edge.first;
+    }
+
+    // Sort each row and squeeze out repeated edges
+    int write = 0;
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+        auto row_begin = neighbors.begin() + offsets[vertex];
+        auto row_end = neighbors.begin() + offsets[vertex + 1];
+        std::sort(row_begin, row_end);
+        auto unique_end = std::unique(row_begin, row_end);
+        int row_size = static_cast<int>(unique_end - row_begin);
+        if (write != offsets[vertex])
+            std::copy(row_begin, unique_end, neighbors.begin() + write);
+        offsets[vertex] = write;
+        write += row_size;
+    }
+    offsets[num_vertices] = write;
+    neighbors.resize(write);
+    neighbors.shrink_to_fit();
+    adopt(std::move(offsets), std::move(neighbors));
+}
+
+void CSRAdjacency::addIsolatedVertices(int count) {
+    std::vector<int> new_offsets(offsets.begin(), offsets.end());
+    new_offsets.insert(new_offsets.end(), count, offsets.back());
+    adopt(std::move(new_offsets), std::vector<int>(neighbors.begin(), neighbors.end()));
+}
+
+bool CSRAdjacency::hasEdge(int vertex1, int vertex2) const {
+    auto row = getNeighbors(vertex1);
+    return std::binary_search(row.begin(), row.end(), vertex2);
+}
+
+std::vector<std::pair<int, int>> CSRAdjacency::getEdges() const {
+    std::vector<std::pair<int, int>> edges;
+    edges.reserve(neighbors.size() / 2 + 1);
+    for (int vertex = 0; vertex < numVertices(); vertex++) {
+        for (int neighbor : getNeighbors(vertex)) {
+            if (vertex <= neighbor)
+                edges.emplace_back(vertex, neighbor);
+        }
+    }
+    return edges;
+}
+
+std::size_t InducedSubgraph::numEdges() const {
+    std::size_t count = 0;
+    for (std::size_t row = 0; row < vertices.size(); row++)
+        for (int entry = offsets[row]; entry < offsets[row + 1]; entry++)
+            count += vertices[row] <= neighbors[entry];
+    return count;
+}
+
+InducedSubgraph CSRAdjacency::getInducedSubgraph(const base::dynamic_bitset<> &members, int first_vertex) const {
+    InducedSubgraph subgraph;
+    subgraph.offsets.push_back(0);
+    const auto num_members = static_cast<unsigned>(members.size());
+    const auto member_blocks = members.block_begin();
+    constexpr auto block_bits = base::bit_size<base::dynamic_bitset<>::block_type>();
+
+    members.visit_set([&](auto bit) {
+        const int vertex = first_vertex + static_cast<int>(bit);
+        if (vertex >= numVertices())
+            return;
+        subgraph.vertices.push_back(vertex);
+
+        // Write every neighbor and only advance over the ones inside the set, so the loop has no data dependent
+        // branches
+        const auto row = getNeighbors(vertex);
+        std::size_t size = subgraph.neighbors.size();
+        subgraph.neighbors.resize(size + row.size());
+        int *out = subgraph.neighbors.data() + size;
+        for (int neighbor : row) {
+            const auto local = static_cast<unsigned>(neighbor - first_vertex);
+            const bool inside = local < num_members
+                                && ((member_blocks[local / block_bits] >> (local % block_bits)) & 1u);
+            *out = neighbor;
+            out += inside;
+        }
+        subgraph.neighbors.resize(out - subgraph.neighbors.data());
+        subgraph.offsets.push_back(static_cast<int>(subgraph.neighbors.size()));
+    });
+    return subgraph;
+}
+
+std::vector<InducedSubgraph> CSRAdjacency::getInducedSubgraphs(const std::vector<base::dynamic_bitset<>> &members,
+                                                               int first_vertex, int num_threads) const {
+    std::vector<InducedSubgraph> subgraphs(members.size());
+    parallelFor(members.size(), [&](std::size_t set, int) {
+        subgraphs[set] = getInducedSubgraph(members[set], first_vertex);
+    }, num_threads);
+    return subgraphs;
+}
+
+InducedSubgraph CSRAdjacency::getInducedSubgraph(const HybridSet &members, int first_vertex) const {
+    InducedSubgraph subgraph;
+    subgraph.offsets.push_back(0);
+    members.visit([&](int member) {
+        const int vertex = first_vertex + member;
+        if (vertex >= numVertices())
+            return;
+        subgraph.vertices.push_back(vertex);
+        for (int neighbor : getNeighbors(vertex))
+            if (members.contains(neighbor - first_vertex))
+                subgraph.neighbors.push_back(neighbor);
+        subgraph.offsets.push_back(static_cast<int>(subgraph.neighbors.size()));
+    });
+    return subgraph;
+}
+
+std::vector<InducedSubgraph> CSRAdjacency::getInducedSubgraphs(const std::vector<HybridSet> &members,
+                                                               int first_vertex, int num_threads) const {
+    std::vector<InducedSubgraph> subgraphs(members.size());
+    parallelFor(members.size(), [&](std::size_t set, int) {
+        subgraphs[set] = getInducedSubgraph(members[set], first_vertex);
+    }, num_threads);
+    return subgraphs;
+}
@@ -0,0 +1,85 @@
+#ifndef PROTEOFORMNETWORKS_CSR_HPP
+#define PROTEOFORMNETWORKS_CSR_HPP
+
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+#include "../base/bitset.h"
+#include "hybrid_set.hpp"
+
+// Subgraph induced by a set of vertices, in compressed sparse row format with the original vertex indexes.
+// Row r belongs to vertices[r] and holds its neighbors inside the set in neighbors[offsets[r], offsets[r + 1]).
+struct InducedSubgraph {
+    std::vector<int> vertices;
+    std::vector<int> offsets;
+    std::vector<int> neighbors;
+
+    [[nodiscard]] std::size_t numEdges() const;
+};
+
+// Read-only adjacency in compressed sparse row format.
+// The neighbors of vertex v are stored contiguously and sorted in neighbors[offsets[v], offsets[v + 1]).
+// Edges are undirected, so every edge appears in the rows of both of its end vertices.
+// The arrays live in a shared storage block (built in memory or mapped from a snapshot file), so copies are cheap
+// and all copies see the same memory.
+class CSRAdjacency {
+
+    std::shared_ptr<const void> storage;
+    std::span<const int> offsets;
+    std::span<const int> neighbors;
+
+    void adopt(std::vector<int> &&new_offsets, std::vector<int> &&new_neighbors);
+
+public:
+
+    CSRAdjacency();
+
+    // Builds the adjacency for the vertices [0, num_vertices) from a list of undirected edges.
+    // Repeated edges are stored only once, self loops appear once in the row of the vertex.
+    CSRAdjacency(int num_vertices, const std::vector<std::pair<int, int>> &edges);
+
+    // Uses arrays owned by somebody else, for example a mapped snapshot. The storage is kept alive by the adjacency.
+    CSRAdjacency(std::shared_ptr<const void> storage, std::span<const int> offsets, std::span<const int> neighbors);
+
+    // Appends vertices without neighbors at the end of the index range.
+    void addIsolatedVertices(int count);
+
+    [[nodiscard]] int numVertices() const { return static_cast<int>(offsets.size()) - 1; }
+
+    // Number of stored neighbor entries, that is, twice the number of edges (self loops count once).
+    [[nodiscard]] std::size_t numEntries() const { return neighbors.size(); }
+
+    [[nodiscard]] int degree(int vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+
+    [[nodiscard]] std::span<const int> getNeighbors(int vertex) const {
+        return neighbors.subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+    }
+
+    [[nodiscard]] bool hasEdge(int vertex1, int vertex2) const;
+
+    // Returns each undirected edge once, as (smaller vertex, larger vertex).
+    [[nodiscard]] std::vector<std::pair<int, int>> getEdges() const;
+
+    // Subgraph induced by the vertices first_vertex + i for every bit i set in members. Neighbors outside the
+    // set are dropped with one bit test each.
+    [[nodiscard]] InducedSubgraph getInducedSubgraph(const base::dynamic_bitset<> &members, int first_vertex = 0) const;
+
+    // Induced subgraphs of many vertex sets, extracted in parallel by num_threads workers (0 uses all hardware
+    // threads).
+    [[nodiscard]] std::vector<InducedSubgraph> getInducedSubgraphs(const std::vector<base::dynamic_bitset<>> &members,
+                                                                   int first_vertex = 0, int num_threads = 0) const;
+
+    // Same for members kept as hybrid sets, for example the module vertices, without converting them to bitsets.
+    // Each neighbor is tested with HybridSet::contains.
+    [[nodiscard]] InducedSubgraph getInducedSubgraph(const HybridSet &members, int first_vertex = 0) const;
+
+    [[nodiscard]] std::vector<InducedSubgraph> getInducedSubgraphs(const std::vector<HybridSet> &members,
+                                                                   int first_vertex = 0, int num_threads = 0) const;
+
+    [[nodiscard]] std::span<const int> getOffsets() const { return offsets; }
+
+    [[nodiscard]] std::span<const int> getNeighborEntries() const { return neighbors; }
+};
+
+#endif //PROTEOFORMNETWORKS_CSR_HPP
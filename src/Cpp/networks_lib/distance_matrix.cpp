@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include "distance_matrix.hpp"
+#include "interactome_snapshot.hpp"
+#include "multi_source_bfs.hpp"
+#include "parallel.hpp"
+
+namespace {
+
+    std::size_t paddedRowSize(std::size_t num_vertices) {
+        return (num_vertices + 7) / 8 * 8;
+    }
+}
+
+DistanceMatrix::DistanceMatrix(std::string_view file_matrix, bool verify_checksum) :
+        file(std::make_shared<const MappedFile>(file_matrix)) {
+
+    std::string message = "Invalid distance matrix ";
+    message += file_matrix;
+    message += ": ";
+
+    if (file->size() < sizeof(DistanceMatrixHeader))
+        throw std::runtime_error(message + "file too small.");
+    header = reinterpret_cast<const DistanceMatrixHeader *>(file->data());
+    if (std::memcmp(header->magic, DISTANCE_MATRIX_MAGIC, sizeof(DISTANCE_MATRIX_MAGIC)) != 0)
+        throw std::runtime_error(message + "wrong file type.");
+    if (header->version != DISTANCE_MATRIX_VERSION)
+        throw std::runtime_error(message + "version " + std::to_string(header->version) + ", expected "
+                                 + std::to_string(DISTANCE_MATRIX_VERSION) + ".");
+    // The vertex range must fit an int, since the queries take int node indexes
+    const auto max_int = static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+    if (header->first_vertex < 0 || header->num_vertices > max_int - static_cast<std::uint64_t>(header->first_vertex))
+        throw std::runtime_error(message + "vertex range out of the int range.");
+    const std::size_t rows_size = file->size() - sizeof(DistanceMatrixHeader);
+    // Compares the number of rows instead of multiplying the counts of the header
+    const bool rows_match = header->row_size == 0
+                            ? rows_size == 0
+                            : rows_size % header->row_size == 0 && rows_size / header->row_size == header->num_vertices;
+    if (header->row_size != paddedRowSize(header->num_vertices) || !rows_match)
+        throw std::runtime_error(message + "size does not match the header.");
+    if (verify_checksum && calculateSnapshotChecksum(file->data() + sizeof(DistanceMatrixHeader),
+                                                     file->size() - sizeof(DistanceMatrixHeader)) != header->checksum)
+        throw std::runtime_error(message + "checksum mismatch.");
+
+    rows = reinterpret_cast<const std::uint8_t *>(file->data() + sizeof(DistanceMatrixHeader));
+}
+
+std::span<const std::uint8_t> DistanceMatrix::getRow(int vertex) const {
+    if (!hasVertex(vertex))
+        throw std::out_of_range("Vertex outside the distance matrix.");
+    return {rows + static_cast<std::size_t>(vertex - getFirstVertex()) * header->row_size, header->num_vertices};
+}
+
+std::uint8_t DistanceMatrix::getDistance(int vertex, const base::dynamic_bitset<> &set, bool skip_vertex) const {
+    if (set.size() != header->num_vertices)
+        throw std::invalid_argument("Set size does not match the vertices of the distance matrix.");
+    auto row = getRow(vertex);
+    const std::size_t skipped = skip_vertex ? vertex - getFirstVertex() : row.size();
+    std::uint8_t distance = UNREACHABLE;
+    set.visit_set([&](auto member) {
+        if (member != skipped)
+            distance = std::min(distance, row[member]);
+    });
+    return distance;
+}
+
+void writeDistanceMatrix(std::string_view file_matrix, const CSRAdjacency &adjacency, int first_vertex, int end_vertex,
+                         int num_threads) {
+    if (first_vertex < 0 || end_vertex < first_vertex || end_vertex > adjacency.numVertices())
+        throw std::invalid_argument("The vertex range is not inside the adjacency.");
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    MultiSourceBFS bfs(adjacency, first_vertex, end_vertex);
+
+    DistanceMatrixHeader header{};
+    std::memcpy(header.magic, DISTANCE_MATRIX_MAGIC, sizeof(DISTANCE_MATRIX_MAGIC));
+    header.version = DISTANCE_MATRIX_VERSION;
+    header.first_vertex = first_vertex;
+    header.num_vertices = static_cast<std::uint64_t>(bfs.numVertices());
+    header.row_size = paddedRowSize(header.num_vertices);
+    header.checksum = SNAPSHOT_CHECKSUM_SEED;
+
+    std::ofstream f(file_matrix.data(), std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        std::string message = "Cannot open distance matrix file ";
+        message += file_matrix;
+        message += " at ";
+        message += __FUNCTION__;
+        throw std::runtime_error(message);
+    }
+    f.write(reinterpret_cast<const char *>(&header), sizeof(header));   // Rewritten with the checksum at the end
+
+    // Each group gives one batch of sources to every worker
+    const std::size_t group_size = static_cast<std::size_t>(num_threads) * MultiSourceBFS::MAX_SOURCES;
+    std::vector<std::byte> group_bytes;
+    for (int first_source = 0; first_source < bfs.numVertices(); first_source += static_cast<int>(group_size)) {
+        std::vector<int> sources(std::min<std::size_t>(group_size, bfs.numVertices() - first_source));
+        std::iota(sources.begin(), sources.end(), first_source);
+        auto group_rows = bfs.getDistanceRows(sources, num_threads);
+
+        group_bytes.assign(sources.size() * header.row_size, std::byte{0});
+        for (std::size_t row = 0; row < group_rows.size(); row++)
+            std::memcpy(group_bytes.data() + row * header.row_size, group_rows[row].data(), group_rows[row].size());
+        header.checksum = calculateSnapshotChecksum(group_bytes.data(), group_bytes.size(), header.checksum);
+        f.write(reinterpret_cast<const char *>(group_bytes.data()), static_cast<std::streamsize>(group_bytes.size()));
+    }
+
+    f.seekp(0);
+    f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!f)
+        throw std::runtime_error("Could not write the complete distance matrix.");
+}
+
+void writeDistanceMatrix(std::string_view file_matrix, const Interactome &interactome, Level level, int num_threads) {
+    writeDistanceMatrix(file_matrix, interactome.getAdjacency(), interactome.getStartIndex(level),
+                        interactome.getEndIndex(level) + 1, num_threads);
+}
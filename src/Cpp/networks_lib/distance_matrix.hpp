@@ -0,0 +1,82 @@
+#ifndef PROTEOFORMNETWORKS_DISTANCE_MATRIX_HPP
+#define PROTEOFORMNETWORKS_DISTANCE_MATRIX_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include "../base/bitset.h"
+#include "csr.hpp"
+#include "Interactome.hpp"
+#include "mapped_file.hpp"
+#include "types.hpp"
+
+// Binary file with the hop distances between all pairs of vertices of a range, for example the genes or the proteins
+// of the interactome, written once and then mapped read-only.
+// Layout, in native byte order: header | one row of uint8 distances per vertex, each row padded to a multiple of
+// 8 bytes. Vertices out of reach, or farther than 254 hops, have distance UNREACHABLE.
+// The header checksum covers everything after the header.
+struct DistanceMatrixHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::int32_t first_vertex;
+    std::uint64_t num_vertices;
+    std::uint64_t row_size;
+    std::uint64_t checksum;
+};
+
+const char DISTANCE_MATRIX_MAGIC[8] = {'P', 'F', 'N', 'D', 'I', 'S', 'T', '\0'};
+const std::uint32_t DISTANCE_MATRIX_VERSION = 1;
+
+// Queries take interactome node indexes. Sets are bitsets over the range, where bit i is the node first_vertex + i,
+// as in the module bitsets.
+class DistanceMatrix {
+
+    std::shared_ptr<const MappedFile> file;
+    const DistanceMatrixHeader *header;
+    const std::uint8_t *rows;
+
+public:
+
+    static constexpr std::uint8_t UNREACHABLE = 255;
+
+    // Maps the matrix file. Throws if the file is not a distance matrix of the current version, if its size does
+    // not match the header, or if the checksum does not match when verification is requested.
+    explicit DistanceMatrix(std::string_view file_matrix, bool verify_checksum = true);
+
+    [[nodiscard]] int numVertices() const { return static_cast<int>(header->num_vertices); }
+
+    [[nodiscard]] int getFirstVertex() const { return header->first_vertex; }
+
+    [[nodiscard]] bool hasVertex(int vertex) const {
+        return getFirstVertex() <= vertex && vertex < getFirstVertex() + numVertices();
+    }
+
+    // Distances from the vertex to the vertices of the range. Throws std::out_of_range for vertices outside it.
+    [[nodiscard]] std::span<const std::uint8_t> getRow(int vertex) const;
+
+    [[nodiscard]] std::uint8_t getDistance(int vertex1, int vertex2) const {
+        auto row = getRow(vertex1);
+        if (!hasVertex(vertex2))
+            throw std::out_of_range("Vertex outside the distance matrix.");
+        return row[vertex2 - getFirstVertex()];
+    }
+
+    // Distance from the vertex to the nearest member of the set, without the vertex itself when skip_vertex is set.
+    // UNREACHABLE for sets without reachable members. Throws std::invalid_argument for sets of another size.
+    [[nodiscard]] std::uint8_t getDistance(int vertex, const base::dynamic_bitset<> &set,
+                                           bool skip_vertex = false) const;
+};
+
+// Computes the distances between the vertices [first_vertex, end_vertex) of the adjacency, through the edges between
+// them, with multi source BFS on num_threads workers (0 uses all hardware threads). The rows are written as they are
+// computed, so only a group of rows per worker is kept in memory.
+void writeDistanceMatrix(std::string_view file_matrix, const CSRAdjacency &adjacency, int first_vertex, int end_vertex,
+                         int num_threads = 0);
+
+// Distances between the nodes of the level, through the interactions between them.
+void writeDistanceMatrix(std::string_view file_matrix, const Interactome &interactome, Level level,
+                         int num_threads = 0);
+
+#endif //PROTEOFORMNETWORKS_DISTANCE_MATRIX_HPP
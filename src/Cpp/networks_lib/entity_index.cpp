@@ -0,0 +1,51 @@
+#include "entity_index.hpp"
+
+EntityIndex::EntityIndex(const vb &sets) :
+        num_entities(sets.empty() ? 0 : sets.front().size()),
+        module_offsets(sets.size() + 1, 0) {
+
+    for (std::size_t I = 0; I < sets.size(); I++) {
+        if (sets[I].size() > num_entities)
+            num_entities = sets[I].size();
+        sets[I].visit_set([&](auto entity) { module_entities.push_back(static_cast<int>(entity)); });
+        module_offsets[I + 1] = static_cast<int>(module_entities.size());
+    }
+    buildPostings();
+}
+
+EntityIndex::EntityIndex(const std::vector<HybridSet> &sets) :
+        num_entities(0),
+        module_offsets(sets.size() + 1, 0) {
+
+    for (std::size_t I = 0; I < sets.size(); I++) {
+        if (sets[I].universeSize() > num_entities)
+            num_entities = sets[I].universeSize();
+        sets[I].visit([&](int entity) { module_entities.push_back(entity); });
+        module_offsets[I + 1] = static_cast<int>(module_entities.size());
+    }
+    buildPostings();
+}
+
+// Counting sort of the (module, entity) entries by entity. The modules are visited in order, so every posting
+// ends up sorted.
+void EntityIndex::buildPostings() {
+    entity_offsets.assign(num_entities + 1, 0);
+    for (int entity : module_entities)
+        entity_offsets[entity + 1]++;
+    for (std::size_t entity = 0; entity < num_entities; entity++)
+        entity_offsets[entity + 1] += entity_offsets[entity];
+
+    entity_modules.resize(module_entities.size());
+    std::vector<int> next(entity_offsets.begin(), entity_offsets.end() - 1);
+    for (std::size_t module = 0; module < numModules(); module++)
+        for (int entity : getEntities(static_cast<int>(module)))
+            entity_modules[next[entity]++] = static_cast<int>(module);
+}
+
+std::vector<int> EntityIndex::select(std::size_t min_size, std::size_t max_size) const {
+    std::vector<int> selected;
+    for (std::size_t module = 0; module < numModules(); module++)
+        if (min_size <= cardinality(static_cast<int>(module)) && cardinality(static_cast<int>(module)) <= max_size)
+            selected.push_back(static_cast<int>(module));
+    return selected;
+}
@@ -0,0 +1,110 @@
+#ifndef PROTEOFORMNETWORKS_ENTITY_INDEX_HPP
+#define PROTEOFORMNETWORKS_ENTITY_INDEX_HPP
+
+#include <algorithm>
+#include <span>
+#include <vector>
+#include "hybrid_set.hpp"
+#include "overlap_types.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
+#include "types.hpp"
+
+// Inverted index of a collection of modules: for every entity, the sorted list (posting) of the modules that
+// contain it. It also keeps the sorted entities of every module, so the pairs of modules sharing entities can be
+// found walking the postings of the entities of each module, without looking at the pairs that share nothing.
+// Both directions are stored in compressed sparse row format.
+class EntityIndex {
+
+    std::size_t num_entities;
+    std::vector<int> module_offsets;    // Entities of module m in module_entities[module_offsets[m], module_offsets[m + 1])
+    std::vector<int> module_entities;
+    std::vector<int> entity_offsets;    // Modules of entity e in entity_modules[entity_offsets[e], entity_offsets[e + 1])
+    std::vector<int> entity_modules;
+
+    void buildPostings();
+
+public:
+
+    explicit EntityIndex(const vb &sets);
+
+    explicit EntityIndex(const std::vector<HybridSet> &sets);
+
+    [[nodiscard]] std::size_t numModules() const { return module_offsets.size() - 1; }
+
+    [[nodiscard]] std::size_t numEntities() const { return num_entities; }
+
+    [[nodiscard]] std::size_t cardinality(int module) const {
+        return module_offsets[module + 1] - module_offsets[module];
+    }
+
+    [[nodiscard]] std::span<const int> getEntities(int module) const {
+        return {module_entities.data() + module_offsets[module], cardinality(module)};
+    }
+
+    [[nodiscard]] std::span<const int> getModules(int entity) const {
+        return {entity_modules.data() + entity_offsets[entity],
+                static_cast<std::size_t>(entity_offsets[entity + 1] - entity_offsets[entity])};
+    }
+
+    // Indexes of the modules with min_size <= cardinality <= max_size, in increasing order.
+    [[nodiscard]] std::vector<int> select(std::size_t min_size, std::size_t max_size) const;
+};
+
+// Calculate score between the pairs of modules that share at least one entity, using the inverted index.
+// For each selected module, the postings of its entities give the modules sharing each entity, and the shared
+// entity counts are accumulated in a per-worker counter array. The work is proportional to the co-memberships
+// instead of the number of pairs.
+// The score is called with the overlap counts of the pair. Pairs sharing nothing are never scored, so this only
+// matches the all-pairs getScores for scores that are 0 for disjoint sets.
+// Returns only the sets within the module sizes and with a score greater than 0.
+template<typename R = pair_map<double>, typename S>
+R getScores(const EntityIndex &index, S score_function,
+            const int min_module_size, const int max_module_size, int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(index.numModules(), 1).finish();
+    const std::vector<int> selected = index.select(std::max(min_module_size, 0), max_module_size);
+    std::vector<char> is_selected(index.numModules(), false);
+    for (int module : selected)
+        is_selected[module] = true;
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<R> collector(index.numModules(), num_threads);
+    std::vector<std::vector<int>> shared_counts(num_threads);
+    std::vector<std::vector<int>> touched_modules(num_threads);
+
+    parallelFor(selected.size(), [&](std::size_t task, int worker) {
+        const int module1 = selected[task];
+        auto &shared = shared_counts[worker];
+        auto &touched = touched_modules[worker];
+        if (shared.empty())
+            shared.assign(index.numModules(), 0);
+
+        for (int entity : index.getEntities(module1)) {
+            const auto modules = index.getModules(entity);
+            // The postings are sorted, so the modules after module1 are a suffix
+            for (auto it = std::upper_bound(modules.begin(), modules.end(), module1); it != modules.end(); it++) {
+                if (!is_selected[*it])
+                    continue;
+                if (shared[*it]++ == 0)
+                    touched.push_back(*it);
+            }
+        }
+
+        for (int module2 : touched) {
+            base::overlap_count counts{index.cardinality(module1), index.cardinality(module2),
+                                       static_cast<std::size_t>(shared[module2])};
+            const double score = score_function(counts);
+            if (score > 0)
+                collector.store(worker, module1, module2, score);
+            shared[module2] = 0;
+        }
+        touched.clear();
+    }, num_threads);
+
+    return collector.finish();
+}
+
+#endif //PROTEOFORMNETWORKS_ENTITY_INDEX_HPP
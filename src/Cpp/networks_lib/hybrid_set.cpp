@@ -0,0 +1,308 @@
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include "hybrid_set.hpp"
+
+namespace {
+
+    // Counts common elements of two sorted sequences. When one is much shorter, its elements are searched in the
+    // other instead of merging both.
+    template<typename T>
+    std::size_t countSortedIntersection(const std::vector<T> &small, const std::vector<T> &large) {
+        if (small.size() > large.size())
+            return countSortedIntersection(large, small);
+
+        std::size_t count = 0;
+        if (small.size() * 32 < large.size()) {
+            auto position = large.begin();
+            for (const auto &value : small) {
+                position = std::lower_bound(position, large.end(), value);
+                if (position == large.end())
+                    break;
+                if (*position == value)
+                    count++;
+            }
+            return count;
+        }
+
+        auto it1 = small.begin(), it2 = large.begin();
+        while (it1 != small.end() && it2 != large.end()) {
+            if (*it1 < *it2) {
+                it1++;
+            } else if (*it2 < *it1) {
+                it2++;
+            } else {
+                count++;
+                it1++;
+                it2++;
+            }
+        }
+        return count;
+    }
+}
+
+HybridSet::HybridSet() : HybridSet(0) {
+
+}
+
+HybridSet::HybridSet(std::size_t universe_size) :
+        universe_size(universe_size),
+        cardinality(0),
+        representation(Representation::sorted) {
+
+}
+
+HybridSet::HybridSet(const base::dynamic_bitset<> &set) : HybridSet(set.size()) {
+    std::vector<int> set_members;
+    set_members.reserve(set.count());
+    set.visit_set([&](auto index) { set_members.push_back(static_cast<int>(index)); });
+    *this = HybridSet(set.size(), std::move(set_members));
+}
+
+HybridSet::HybridSet(std::size_t universe_size, std::vector<int> new_members) : HybridSet(universe_size) {
+    std::sort(new_members.begin(), new_members.end());
+    new_members.erase(std::unique(new_members.begin(), new_members.end()), new_members.end());
+    if (!new_members.empty() && (new_members.front() < 0 || new_members.back() >= static_cast<int>(universe_size)))
+        throw std::out_of_range("Tried to create a set with members outside the universe of size "
+                                + std::to_string(universe_size));
+
+    members = std::move(new_members);
+    cardinality = members.size();
+    rebuild(chooseRepresentation(cardinality));
+}
+
+HybridSet::Representation HybridSet::chooseRepresentation(std::size_t num_members) const {
+    if (num_members <= SORTED_LIMIT)
+        return Representation::sorted;
+    if (num_members * 16 >= universe_size)
+        return Representation::dense;
+    return Representation::chunked;
+}
+
+// Moves all members to the new representation
+void HybridSet::rebuild(Representation new_representation) {
+    if (new_representation == representation && representation != Representation::sorted)
+        return;
+
+    std::vector<int> all_members = representation == Representation::sorted ? std::move(members) : getMembers();
+    members.clear();
+    chunks.clear();
+    bits.release();
+    representation = new_representation;
+
+    switch (representation) {
+        case Representation::sorted:
+            members = std::move(all_members);
+            members.shrink_to_fit();
+            break;
+        case Representation::chunked:
+            for (int member : all_members) {
+                auto key = static_cast<std::uint32_t>(member >> CHUNK_BITS);
+                if (chunks.empty() || chunks.back().key != key)
+                    chunks.push_back({key, 0, {}, {}});
+                insertIntoChunk(chunks.back(), static_cast<std::uint16_t>(member & (CHUNK_SIZE - 1)));
+            }
+            break;
+        case Representation::dense:
+            bits = base::dynamic_bitset<>(universe_size);
+            for (int member : all_members)
+                bits[member].set();
+            break;
+    }
+}
+
+const HybridSet::Chunk *HybridSet::findChunk(std::uint32_t key) const {
+    auto chunk = std::lower_bound(chunks.begin(), chunks.end(), key,
+                                  [](const Chunk &c, std::uint32_t k) { return c.key < k; });
+    return chunk != chunks.end() && chunk->key == key ? &*chunk : nullptr;
+}
+
+void HybridSet::insertIntoChunk(Chunk &chunk, std::uint16_t offset) {
+    if (chunk.bitmap.empty()) {
+        auto position = std::lower_bound(chunk.offsets.begin(), chunk.offsets.end(), offset);
+        if (position != chunk.offsets.end() && *position == offset)
+            return;
+        chunk.offsets.insert(position, offset);
+        chunk.count++;
+        if (chunk.count > CHUNK_ARRAY_LIMIT) {   // Switch the chunk to a bitmap
+            chunk.bitmap.assign(CHUNK_BLOCKS, 0);
+            for (auto member : chunk.offsets)
+                base::set_bit(chunk.bitmap[member / base::bit_size<block_type>()],
+                              member % base::bit_size<block_type>());
+            chunk.offsets.clear();
+            chunk.offsets.shrink_to_fit();
+        }
+    } else {
+        auto &block = chunk.bitmap[offset / base::bit_size<block_type>()];
+        if (!base::get_bit(block, offset % base::bit_size<block_type>())) {
+            base::set_bit(block, offset % base::bit_size<block_type>());
+            chunk.count++;
+        }
+    }
+}
+
+bool HybridSet::chunkContains(const Chunk &chunk, std::uint16_t offset) {
+    if (chunk.bitmap.empty())
+        return std::binary_search(chunk.offsets.begin(), chunk.offsets.end(), offset);
+    return base::get_bit(chunk.bitmap[offset / base::bit_size<block_type>()], offset % base::bit_size<block_type>());
+}
+
+void HybridSet::insert(int index) {
+    if (index < 0 || index >= static_cast<int>(universe_size))
+        throw std::out_of_range("Tried to add " + std::to_string(index) + " to a set with universe of size "
+                                + std::to_string(universe_size));
+
+    switch (representation) {
+        case Representation::sorted: {
+            auto position = std::lower_bound(members.begin(), members.end(), index);
+            if (position != members.end() && *position == index)
+                return;
+            members.insert(position, index);
+            break;
+        }
+        case Representation::chunked: {
+            auto key = static_cast<std::uint32_t>(index >> CHUNK_BITS);
+            auto chunk = std::lower_bound(chunks.begin(), chunks.end(), key,
+                                          [](const Chunk &c, std::uint32_t k) { return c.key < k; });
+            if (chunk == chunks.end() || chunk->key != key)
+                chunk = chunks.insert(chunk, {key, 0, {}, {}});
+            auto previous_count = chunk->count;
+            insertIntoChunk(*chunk, static_cast<std::uint16_t>(index & (CHUNK_SIZE - 1)));
+            if (chunk->count == previous_count)
+                return;
+            break;
+        }
+        case Representation::dense:
+            if (bits[index])
+                return;
+            bits[index].set();
+            break;
+    }
+
+    cardinality++;
+    auto chosen = chooseRepresentation(cardinality);
+    if (chosen > representation)
+        rebuild(chosen);
+}
+
+bool HybridSet::contains(int index) const {
+    if (index < 0 || index >= static_cast<int>(universe_size))
+        return false;
+
+    switch (representation) {
+        case Representation::sorted:
+            return std::binary_search(members.begin(), members.end(), index);
+        case Representation::chunked: {
+            auto chunk = findChunk(static_cast<std::uint32_t>(index >> CHUNK_BITS));
+            return chunk != nullptr && chunkContains(*chunk, static_cast<std::uint16_t>(index & (CHUNK_SIZE - 1)));
+        }
+        case Representation::dense:
+            return bits[index];
+    }
+    return false;
+}
+
+std::size_t HybridSet::getMemoryUsage() const {
+    std::size_t bytes = members.capacity() * sizeof(int) + chunks.capacity() * sizeof(Chunk);
+    for (const auto &chunk : chunks)
+        bytes += chunk.offsets.capacity() * sizeof(std::uint16_t) + chunk.bitmap.capacity() * sizeof(block_type);
+    return bytes + bits.blocks() * sizeof(block_type);
+}
+
+std::vector<int> HybridSet::getMembers() const {
+    if (representation == Representation::sorted)
+        return members;
+    std::vector<int> result;
+    result.reserve(cardinality);
+    visit([&](int member) { result.push_back(member); });
+    return result;
+}
+
+base::dynamic_bitset<> HybridSet::toBitset() const {
+    if (representation == Representation::dense)
+        return bits;
+    base::dynamic_bitset<> result(universe_size);
+    visit([&](int member) { result[member].set(); });
+    return result;
+}
+
+std::size_t HybridSet::countChunkIntersection(const Chunk &chunk1, const Chunk &chunk2) {
+    if (chunk1.bitmap.empty() && chunk2.bitmap.empty())
+        return countSortedIntersection(chunk1.offsets, chunk2.offsets);
+
+    if (!chunk1.bitmap.empty() && !chunk2.bitmap.empty()) {
+        std::size_t count = 0;
+        for (std::size_t block = 0; block < CHUNK_BLOCKS; block++)
+            count += base::popcount(chunk1.bitmap[block] & chunk2.bitmap[block]);
+        return count;
+    }
+
+    const Chunk &sparse = chunk1.bitmap.empty() ? chunk1 : chunk2;
+    const Chunk &dense = chunk1.bitmap.empty() ? chunk2 : chunk1;
+    std::size_t count = 0;
+    for (auto offset : sparse.offsets)
+        count += chunkContains(dense, offset);
+    return count;
+}
+
+std::size_t HybridSet::countChunkIntersection(const Chunk &chunk, const base::dynamic_bitset<> &dense) const {
+    const std::size_t chunk_start = static_cast<std::size_t>(chunk.key) << CHUNK_BITS;
+    std::size_t count = 0;
+    if (chunk.bitmap.empty()) {
+        for (auto offset : chunk.offsets)
+            count += chunk_start + offset < dense.size() && dense[chunk_start + offset];
+    } else {
+        // Chunks start at a multiple of the block size, so the chunk blocks line up with the dense blocks
+        const std::size_t first_block = chunk_start / base::bit_size<block_type>();
+        if (first_block >= dense.blocks())
+            return 0;
+        const std::size_t num_blocks = std::min(CHUNK_BLOCKS, dense.blocks() - first_block);
+        for (std::size_t block = 0; block < num_blocks; block++)
+            count += base::popcount(chunk.bitmap[block] & dense.block_begin()[first_block + block]);
+    }
+    return count;
+}
+
+std::size_t countIntersection(const HybridSet &set1, const HybridSet &set2) {
+    using Representation = HybridSet::Representation;
+
+    if (set1.cardinality == 0 || set2.cardinality == 0)
+        return 0;
+    if (set1.representation > set2.representation)    // Only the combinations with set1 <= set2 are handled
+        return countIntersection(set2, set1);
+
+    if (set1.representation == Representation::sorted) {
+        if (set2.representation == Representation::sorted)
+            return countSortedIntersection(set1.members, set2.members);
+        std::size_t count = 0;
+        for (int member : set1.members)
+            count += set2.contains(member);
+        return count;
+    }
+
+    if (set1.representation == Representation::chunked) {
+        std::size_t count = 0;
+        if (set2.representation == Representation::chunked) {
+            auto it1 = set1.chunks.begin(), it2 = set2.chunks.begin();
+            while (it1 != set1.chunks.end() && it2 != set2.chunks.end()) {
+                if (it1->key < it2->key) {
+                    it1++;
+                } else if (it2->key < it1->key) {
+                    it2++;
+                } else {
+                    count += HybridSet::countChunkIntersection(*it1++, *it2++);
+                }
+            }
+        } else {
+            for (const auto &chunk : set1.chunks)
+                count += set1.countChunkIntersection(chunk, set2.bits);
+        }
+        return count;
+    }
+
+    return base::count_intersection(set1.bits, set2.bits);
+}
+
+base::overlap_count countOverlap(const HybridSet &set1, const HybridSet &set2) {
+    return {set1.count(), set2.count(), countIntersection(set1, set2)};
+}
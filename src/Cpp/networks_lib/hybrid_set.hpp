@@ -0,0 +1,123 @@
+#ifndef PROTEOFORMNETWORKS_HYBRID_SET_HPP
+#define PROTEOFORMNETWORKS_HYBRID_SET_HPP
+
+#include <cstdint>
+#include <vector>
+#include "../base/bitset.h"
+
+// Set of indexes in [0, universe size) that chooses its representation by the number of members:
+// - sorted: sorted vector of the members, for small sets.
+// - chunked: roaring style. The universe is split in chunks of 2^16 indexes and each non-empty chunk keeps its
+//   members as sorted 16-bit offsets, or as a bitmap of the chunk once it has more than CHUNK_ARRAY_LIMIT members.
+// - dense: one bit per index of the universe, once that takes no more memory than the 16-bit offsets.
+// The representation only grows while inserting: sorted -> chunked -> dense.
+class HybridSet {
+
+public:
+
+    enum class Representation {
+        sorted, chunked, dense
+    };
+
+    using block_type = base::dynamic_bitset<>::block_type;
+
+    static constexpr std::size_t SORTED_LIMIT = 64;
+    static constexpr std::size_t CHUNK_BITS = 16;
+    static constexpr std::size_t CHUNK_SIZE = std::size_t(1) << CHUNK_BITS;
+    static constexpr std::size_t CHUNK_ARRAY_LIMIT = 4096;
+    static constexpr std::size_t CHUNK_BLOCKS = CHUNK_SIZE / base::bit_size<block_type>();
+
+private:
+
+    struct Chunk {
+        std::uint32_t key;                    // Index of the chunk: member >> CHUNK_BITS
+        std::size_t count;
+        std::vector<std::uint16_t> offsets;   // Sorted members while the chunk is sparse
+        std::vector<block_type> bitmap;       // CHUNK_BLOCKS blocks once the chunk is dense
+    };
+
+    std::size_t universe_size;
+    std::size_t cardinality;
+    Representation representation;
+    std::vector<int> members;
+    std::vector<Chunk> chunks;
+    base::dynamic_bitset<> bits;
+
+    [[nodiscard]] Representation chooseRepresentation(std::size_t num_members) const;
+
+    void rebuild(Representation new_representation);
+
+    [[nodiscard]] const Chunk *findChunk(std::uint32_t key) const;
+
+    static void insertIntoChunk(Chunk &chunk, std::uint16_t offset);
+
+    static bool chunkContains(const Chunk &chunk, std::uint16_t offset);
+
+    static std::size_t countChunkIntersection(const Chunk &chunk1, const Chunk &chunk2);
+
+    std::size_t countChunkIntersection(const Chunk &chunk, const base::dynamic_bitset<> &dense) const;
+
+public:
+
+    HybridSet();
+
+    explicit HybridSet(std::size_t universe_size);
+
+    explicit HybridSet(const base::dynamic_bitset<> &set);
+
+    HybridSet(std::size_t universe_size, std::vector<int> members);
+
+    // Adds the index to the set. Throws std::out_of_range for indexes outside the universe.
+    void insert(int index);
+
+    [[nodiscard]] bool contains(int index) const;
+
+    [[nodiscard]] std::size_t count() const { return cardinality; }
+
+    [[nodiscard]] std::size_t universeSize() const { return universe_size; }
+
+    [[nodiscard]] Representation getRepresentation() const { return representation; }
+
+    // Bytes used by the members, not counting the object itself.
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+    // Calls f(index) for every member in increasing order.
+    template<typename F>
+    void visit(F &&f) const {
+        switch (representation) {
+            case Representation::sorted:
+                for (int member : members)
+                    f(member);
+                break;
+            case Representation::chunked:
+                for (const auto &chunk : chunks) {
+                    const int chunk_start = static_cast<int>(chunk.key << CHUNK_BITS);
+                    if (chunk.bitmap.empty()) {
+                        for (auto offset : chunk.offsets)
+                            f(chunk_start + offset);
+                    } else {
+                        for (std::size_t block = 0; block < CHUNK_BLOCKS; block++)
+                            base::visit_set_bits(chunk.bitmap[block], [&](auto bit) {
+                                f(chunk_start + static_cast<int>(block * base::bit_size<block_type>() + bit));
+                            });
+                    }
+                }
+                break;
+            case Representation::dense:
+                bits.visit_set([&](auto index) { f(static_cast<int>(index)); });
+                break;
+        }
+    }
+
+    [[nodiscard]] std::vector<int> getMembers() const;
+
+    [[nodiscard]] base::dynamic_bitset<> toBitset() const;
+
+    // |A & B| for any combination of representations.
+    friend std::size_t countIntersection(const HybridSet &set1, const HybridSet &set2);
+};
+
+// |A|, |B| and |A & B| for any combination of representations.
+base::overlap_count countOverlap(const HybridSet &set1, const HybridSet &set2);
+
+#endif //PROTEOFORMNETWORKS_HYBRID_SET_HPP
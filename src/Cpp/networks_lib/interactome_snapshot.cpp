@@ -0,0 +1,214 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "interactome_snapshot.hpp"
+
+namespace {
+
+    std::size_t padded(std::size_t size) {
+        return (size + 7) / 8 * 8;
+    }
+
+    struct SnapshotSections {
+        std::size_t ranges, node_flags, offsets, neighbors, name_offsets, names, end;
+    };
+
+    // Byte position of each section, counting from the start of the file. The counts in the header must already be
+    // bounded by the file size.
+    SnapshotSections locateSections(const SnapshotHeader &header) {
+        SnapshotSections sections{};
+        sections.ranges = sizeof(SnapshotHeader);
+        sections.node_flags = sections.ranges + padded(2 * header.num_levels * sizeof(int));
+        sections.offsets = sections.node_flags + padded(header.num_vertices * sizeof(std::uint8_t));
+        sections.neighbors = sections.offsets + padded((header.num_vertices + 1) * sizeof(int));
+        sections.name_offsets = sections.neighbors + padded(header.num_entries * sizeof(int));
+        sections.names = sections.name_offsets + (header.num_vertices + 1) * sizeof(std::uint64_t);
+        sections.end = sections.names + padded(header.names_size);
+        return sections;
+    }
+
+    void appendPadded(std::vector<std::byte> &payload, const void *data, std::size_t size) {
+        auto bytes = static_cast<const std::byte *>(data);
+        payload.insert(payload.end(), bytes, bytes + size);
+        payload.resize(padded(payload.size()), std::byte{0});
+    }
+}
+
+std::uint64_t calculateSnapshotChecksum(const std::byte *data, std::size_t size, std::uint64_t seed) {
+    std::uint64_t hash = seed;
+    for (std::size_t position = 0; position < size; position += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, data + position, sizeof(word));
+        hash = (hash ^ word) * 1099511628211ull;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+InteractomeSnapshot::InteractomeSnapshot(std::string_view file_snapshot, bool verify_checksum) :
+        file(std::make_shared<const MappedFile>(file_snapshot)) {
+
+    std::string message = "Invalid interactome snapshot ";
+    message += file_snapshot;
+    message += ": ";
+
+    if (file->size() < sizeof(SnapshotHeader))
+        throw std::runtime_error(message + "file too small.");
+    header = reinterpret_cast<const SnapshotHeader *>(file->data());
+    if (std::memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0)
+        throw std::runtime_error(message + "wrong file type.");
+    if (header->version != SNAPSHOT_VERSION)
+        throw std::runtime_error(message + "version " + std::to_string(header->version) + ", expected "
+                                 + std::to_string(SNAPSHOT_VERSION) + ".");
+
+    // The counts are bounded by the file size before computing any section position, so the positions cannot wrap
+    const std::size_t size = file->size();
+    if (header->num_levels > size / (2 * sizeof(int)) || header->num_vertices > size / sizeof(std::uint64_t)
+        || header->num_vertices > static_cast<std::uint64_t>(std::numeric_limits<int>::max())
+        || header->num_entries > size / sizeof(int) || header->names_size > size)
+        throw std::runtime_error(message + "counts in the header exceed the file size.");
+
+    auto sections = locateSections(*header);
+    if (sections.end != file->size())
+        throw std::runtime_error(message + "size does not match the header.");
+    if (verify_checksum && calculateSnapshotChecksum(file->data() + sizeof(SnapshotHeader),
+                                                     file->size() - sizeof(SnapshotHeader)) != header->checksum)
+        throw std::runtime_error(message + "checksum mismatch.");
+
+    auto at = [&](std::size_t position) { return file->data() + position; };
+    ranges = {reinterpret_cast<const int *>(at(sections.ranges)), 2 * header->num_levels};
+    node_flags = {reinterpret_cast<const std::uint8_t *>(at(sections.node_flags)), header->num_vertices};
+    offsets = {reinterpret_cast<const int *>(at(sections.offsets)), header->num_vertices + 1};
+    neighbors = {reinterpret_cast<const int *>(at(sections.neighbors)), header->num_entries};
+    name_offsets = {reinterpret_cast<const std::uint64_t *>(at(sections.name_offsets)), header->num_vertices + 1};
+    names = reinterpret_cast<const char *>(at(sections.names));
+
+    // Checked even without the checksum, the adjacency and the names are read without bounds checks
+    if (offsets.front() != 0 || static_cast<std::uint64_t>(offsets.back()) != header->num_entries)
+        throw std::runtime_error(message + "adjacency offsets do not match the number of neighbors.");
+    for (std::size_t vertex = 0; vertex < header->num_vertices; vertex++)
+        if (offsets[vertex + 1] < offsets[vertex])
+            throw std::runtime_error(message + "adjacency offsets are not monotonic.");
+    for (int neighbor : neighbors)
+        if (neighbor < 0 || static_cast<std::uint64_t>(neighbor) >= header->num_vertices)
+            throw std::runtime_error(message + "neighbor out of the vertex range.");
+    if (name_offsets.front() != 0 || name_offsets.back() != header->names_size)
+        throw std::runtime_error(message + "name offsets do not match the names size.");
+    for (std::size_t vertex = 0; vertex < header->num_vertices; vertex++)
+        if (name_offsets[vertex + 1] < name_offsets[vertex])
+            throw std::runtime_error(message + "name offsets are not monotonic.");
+}
+
+CSRAdjacency InteractomeSnapshot::getAdjacency() const {
+    return CSRAdjacency(file, offsets, neighbors);
+}
+
+void writeInteractomeSnapshot(std::string_view file_snapshot,
+                              const std::vector<int> &start_indexes,
+                              const std::vector<int> &end_indexes,
+                              const CSRAdjacency &adjacency,
+                              const std::vector<std::string> &names,
+                              const std::vector<std::uint8_t> &node_flags) {
+
+    if (start_indexes.size() != end_indexes.size())
+        throw std::invalid_argument("The start and end indexes of the levels do not match.");
+    if (names.size() != static_cast<std::size_t>(adjacency.numVertices()))
+        throw std::invalid_argument("There must be one name for each vertex of the adjacency.");
+    if (node_flags.size() != names.size())
+        throw std::invalid_argument("There must be one set of node flags for each vertex of the adjacency.");
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.num_levels = static_cast<std::uint32_t>(start_indexes.size());
+    header.num_vertices = static_cast<std::uint64_t>(adjacency.numVertices());
+    header.num_entries = adjacency.numEntries();
+
+    std::vector<int> ranges;
+    for (std::size_t level = 0; level < start_indexes.size(); level++) {
+        ranges.push_back(start_indexes[level]);
+        ranges.push_back(end_indexes[level]);
+    }
+
+    std::vector<std::uint64_t> name_offsets(1, 0);
+    std::string pool;
+    for (const auto &name : names) {
+        pool += name;
+        name_offsets.push_back(pool.size());
+    }
+    header.names_size = pool.size();
+
+    std::vector<std::byte> payload;
+    payload.reserve(locateSections(header).end);
+    appendPadded(payload, ranges.data(), ranges.size() * sizeof(int));
+    appendPadded(payload, node_flags.data(), node_flags.size());
+    appendPadded(payload, adjacency.getOffsets().data(), adjacency.getOffsets().size_bytes());
+    appendPadded(payload, adjacency.getNeighborEntries().data(), adjacency.getNeighborEntries().size_bytes());
+    appendPadded(payload, name_offsets.data(), name_offsets.size() * sizeof(std::uint64_t));
+    appendPadded(payload, pool.data(), pool.size());
+    header.checksum = calculateSnapshotChecksum(payload.data(), payload.size());
+
+    std::ofstream f(file_snapshot.data(), std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) {
+        std::string message = "Cannot open snapshot file ";
+        message += file_snapshot;
+        message += " at ";
+        message += __FUNCTION__;
+        throw std::runtime_error(message);
+    }
+    f.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    f.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    if (!f)
+        throw std::runtime_error("Could not write the complete interactome snapshot.");
+}
+
+void convertInteractomeToSnapshot(std::string_view file_vertices,
+                                  std::string_view file_edges,
+                                  std::string_view file_ranges,
+                                  std::string_view file_snapshot) {
+
+    std::string function = __FUNCTION__;
+    auto open_file = [&function](std::string_view path, std::ifstream &f) {
+        f.open(path.data());
+        if (!f.is_open()) {
+            std::string message = "Cannot open file ";
+            message += path;
+            message += " at ";
+            throw std::runtime_error(message + function);
+        }
+    };
+
+    std::cout << "Reading vertices...\n";
+    std::ifstream f_vertices;
+    open_file(file_vertices, f_vertices);
+    std::vector<std::string> names;
+    std::string name;
+    while (f_vertices >> name)
+        names.push_back(name);
+
+    std::cout << "Reading edges...\n";
+    std::ifstream f_edges;
+    open_file(file_edges, f_edges);
+    std::vector<std::pair<int, int>> edges;
+    int i1, i2;
+    while (f_edges >> i1 >> i2)
+        edges.emplace_back(i1, i2);
+
+    std::cout << "Reading index ranges...\n";
+    std::ifstream f_ranges;
+    open_file(file_ranges, f_ranges);
+    std::vector<int> start_indexes, end_indexes;
+    int start_index, end_index;
+    while (f_ranges >> start_index >> end_index) {
+        start_indexes.push_back(start_index);
+        end_indexes.push_back(end_index);
+    }
+
+    std::cout << "Writing snapshot " << file_snapshot << "...\n";
+    writeInteractomeSnapshot(file_snapshot, start_indexes, end_indexes,
+                             CSRAdjacency(static_cast<int>(names.size()), edges), names,
+                             std::vector<std::uint8_t>(names.size(), SNAPSHOT_NODE_PRESENT | SNAPSHOT_NODE_NAMED));
+    std::cout << "Complete.\n\n";
+}
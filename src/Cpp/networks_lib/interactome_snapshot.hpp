@@ -0,0 +1,99 @@
+#ifndef PROTEOFORMNETWORKS_INTERACTOME_SNAPSHOT_HPP
+#define PROTEOFORMNETWORKS_INTERACTOME_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "csr.hpp"
+#include "mapped_file.hpp"
+
+// Binary snapshot of the indexed interactome, written once and then mapped read-only.
+// Layout, in native byte order, with every section starting at a multiple of 8 bytes:
+//   header | level ranges (start, end) as int32 | node flags as uint8 | CSR offsets as int32 | CSR neighbors as int32
+//   | name offsets as uint64 | name characters, without separators
+// The node flags tell the vertices that are nodes of the interactome and the nodes with a name, so index gaps and
+// unnamed nodes survive the round trip. Vertices without a name have an empty name in the pool.
+// The header checksum covers everything after the header. The adjacency and the name offsets are also checked on every
+// load, so a damaged file is rejected instead of making reads go out of bounds.
+struct SnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_levels;
+    std::uint64_t num_vertices;
+    std::uint64_t num_entries;
+    std::uint64_t names_size;
+    std::uint64_t checksum;
+};
+
+const char SNAPSHOT_MAGIC[8] = {'P', 'F', 'N', 'S', 'N', 'A', 'P', '\0'};
+const std::uint32_t SNAPSHOT_VERSION = 2;
+
+// Bits of the node flags
+const std::uint8_t SNAPSHOT_NODE_PRESENT = 1;
+const std::uint8_t SNAPSHOT_NODE_NAMED = 2;
+
+const std::uint64_t SNAPSHOT_CHECKSUM_SEED = 14695981039346656037ull;
+
+// Checksum over 64-bit words, the length must be a multiple of 8 bytes. Passing the checksum of the data before as
+// the seed continues it, so large files can be checked in pieces.
+std::uint64_t calculateSnapshotChecksum(const std::byte *data, std::size_t size,
+                                        std::uint64_t seed = SNAPSHOT_CHECKSUM_SEED);
+
+class InteractomeSnapshot {
+
+    std::shared_ptr<const MappedFile> file;
+    const SnapshotHeader *header;
+    std::span<const int> ranges;
+    std::span<const std::uint8_t> node_flags;
+    std::span<const int> offsets;
+    std::span<const int> neighbors;
+    std::span<const std::uint64_t> name_offsets;
+    const char *names;
+
+public:
+
+    // Maps the snapshot file. Throws if the file is not a snapshot of the current version, if its size does not
+    // match the header, if the adjacency or the name offsets are malformed, or if the checksum does not match when
+    // verification is requested.
+    explicit InteractomeSnapshot(std::string_view file_snapshot, bool verify_checksum = true);
+
+    [[nodiscard]] int numVertices() const { return static_cast<int>(header->num_vertices); }
+
+    [[nodiscard]] int numLevels() const { return static_cast<int>(header->num_levels); }
+
+    [[nodiscard]] int getStartIndex(int level) const { return ranges[2 * level]; }
+
+    [[nodiscard]] int getEndIndex(int level) const { return ranges[2 * level + 1]; }
+
+    [[nodiscard]] bool isPresent(int vertex) const { return node_flags[vertex] & SNAPSHOT_NODE_PRESENT; }
+
+    [[nodiscard]] bool isNamed(int vertex) const { return node_flags[vertex] & SNAPSHOT_NODE_NAMED; }
+
+    [[nodiscard]] std::string_view getName(int vertex) const {
+        return {names + name_offsets[vertex], name_offsets[vertex + 1] - name_offsets[vertex]};
+    }
+
+    // Adjacency reading directly from the mapped pages. It keeps the mapping alive.
+    [[nodiscard]] CSRAdjacency getAdjacency() const;
+};
+
+void writeInteractomeSnapshot(std::string_view file_snapshot,
+                              const std::vector<int> &start_indexes,
+                              const std::vector<int> &end_indexes,
+                              const CSRAdjacency &adjacency,
+                              const std::vector<std::string> &names,
+                              const std::vector<std::uint8_t> &node_flags);
+
+// Converts the text interactome files into a snapshot:
+// - Vertices: one name per line, the line number is the index.
+// - Edges: two vertex indexes per line.
+// - Ranges: start and end index (inclusive) per line, one line per level.
+void convertInteractomeToSnapshot(std::string_view file_vertices,
+                                  std::string_view file_edges,
+                                  std::string_view file_ranges,
+                                  std::string_view file_snapshot);
+
+#endif //PROTEOFORMNETWORKS_INTERACTOME_SNAPSHOT_HPP
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <limits>
+#include "interface_engine.hpp"
+#include "parallel.hpp"
+
+InterfaceEngine::InterfaceEngine(const vb &sets, const CSRAdjacency &adjacency, int first_vertex, int num_threads) :
+        module_sets(sets),
+        neighborhoods(sets.size()),
+        incident_edges(sets.size()) {
+
+    const int num_vertices = sets.empty() ? 0 : static_cast<int>(sets.front().size());
+    const int end_vertex = std::min(first_vertex + num_vertices, adjacency.numVertices());
+    auto in_level = [&](int vertex) { return first_vertex <= vertex && vertex < first_vertex + num_vertices; };
+
+    has_edges = base::dynamic_bitset<>(num_vertices);
+    for (int vertex = std::max(first_vertex, 0); vertex < end_vertex; vertex++)
+        for (int neighbor : adjacency.getNeighbors(vertex))
+            if (in_level(neighbor)) {
+                has_edges[vertex - first_vertex].set();
+                break;
+            }
+
+    parallelFor(sets.size(), [&](std::size_t module, int) {
+        const auto &members = sets[module];
+        auto &neighborhood = neighborhoods[module];
+        auto &edges = incident_edges[module];
+        neighborhood = base::dynamic_bitset<>(num_vertices);
+        members.visit_set([&](auto member) {
+            const int vertex = first_vertex + static_cast<int>(member);
+            if (vertex >= end_vertex)
+                return;
+            for (int neighbor : adjacency.getNeighbors(vertex)) {
+                if (!in_level(neighbor))
+                    continue;
+                const int local = neighbor - first_vertex;
+                neighborhood[local].set();
+                // Edges with both ends in the module are listed from the smaller end only
+                if (local != static_cast<int>(member) && (!members[local] || static_cast<int>(member) < local))
+                    edges.emplace_back(std::min<int>(member, local), std::max<int>(member, local));
+            }
+        });
+    }, num_threads);
+}
+
+std::size_t InterfaceEngine::countInterfaceNodes(std::size_t module1, std::size_t module2) const {
+    const auto *a = module_sets[module1].block_begin(), *b = module_sets[module2].block_begin();
+    const auto *neighbors1 = neighborhoods[module1].block_begin(), *neighbors2 = neighborhoods[module2].block_begin();
+    const auto *connected = has_edges.block_begin();
+
+    // Outside the block ranges of the two modules there are no members
+    std::size_t first_block = std::numeric_limits<std::size_t>::max(), end_block = 0;
+    for (std::size_t module : {module1, module2}) {
+        if (module_sets.cardinality(module) > 0) {
+            first_block = std::min(first_block, module_sets.firstBlock(module));
+            end_block = std::max(end_block, module_sets.endBlock(module));
+        }
+    }
+
+    std::size_t count = 0;
+    for (std::size_t block = first_block; block < end_block; block++)
+        count += base::popcount((a[block] & neighbors2[block]) | (b[block] & neighbors1[block])
+                                | (a[block] & b[block] & connected[block]));
+    return count;
+}
+
+std::size_t InterfaceEngine::countInterfaceEdges(std::size_t module1, std::size_t module2) const {
+    const auto &set1 = module_sets[module1], &set2 = module_sets[module2];
+    auto inside_one_module = [&](int end1, int end2) {
+        return (set1[end1] && set1[end2] && !set2[end1] && !set2[end2])
+               || (set2[end1] && set2[end2] && !set1[end1] && !set1[end2]);
+    };
+
+    std::size_t count = 0;
+    for (const auto &[end1, end2] : incident_edges[module1])
+        count += !inside_one_module(end1, end2);
+    for (const auto &[end1, end2] : incident_edges[module2])    // The edges touching module1 were counted already
+        count += !set1[end1] && !set1[end2] && !inside_one_module(end1, end2);
+    return count;
+}
+
+pair_map<double> getScores(const InterfaceEngine &engine, InterfaceMeasure measure, const pair_map<double> &prev_scores,
+                           int num_threads) {
+    std::vector<std::pair<int, int>> pairs;
+    pairs.reserve(prev_scores.size());
+    for (const auto &entry : prev_scores)
+        pairs.push_back(entry.first);
+
+    // Tasks of PAIRS_PER_TASK pairs, so taking a task costs little next to counting
+    constexpr std::size_t PAIRS_PER_TASK = 256;
+    std::vector<double> sizes(pairs.size());
+    parallelFor((pairs.size() + PAIRS_PER_TASK - 1) / PAIRS_PER_TASK, [&](std::size_t task, int) {
+        const std::size_t end = std::min((task + 1) * PAIRS_PER_TASK, pairs.size());
+        for (std::size_t pair = task * PAIRS_PER_TASK; pair < end; pair++)
+            sizes[pair] = static_cast<double>(engine.countInterface(pairs[pair].first, pairs[pair].second, measure));
+    }, num_threads);
+
+    pair_map<double> result;
+    result.reserve(pairs.size());
+    for (std::size_t pair = 0; pair < pairs.size(); pair++)
+        result[pairs[pair]] = sizes[pair];
+    return result;
+}
+
+namespace {
+
+    InterfaceEngine makePairEngine(const base::dynamic_bitset<> &V1, const base::dynamic_bitset<> &V2, const vusi &E,
+                                   vb &sets) {
+        std::vector<std::pair<int, int>> edges;
+        for (int vertex = 0; vertex < static_cast<int>(E.size()); vertex++)
+            for (int neighbor : E[vertex])
+                if (vertex <= neighbor)
+                    edges.emplace_back(vertex, neighbor);
+        sets = {V1, V2};
+        return {sets, CSRAdjacency(static_cast<int>(std::max(E.size(), V1.size())), edges), 0, 1};
+    }
+}
+
+double calculate_interface_size_nodes(const base::dynamic_bitset<> &V1,
+                                      const base::dynamic_bitset<> &V2,
+                                      const vusi &E) {
+    vb sets;
+    return static_cast<double>(makePairEngine(V1, V2, E, sets).countInterfaceNodes(0, 1));
+}
+
+double calculate_interface_size_edges(const base::dynamic_bitset<> &V1,
+                                      const base::dynamic_bitset<> &V2,
+                                      const vusi &E) {
+    vb sets;
+    return static_cast<double>(makePairEngine(V1, V2, E, sets).countInterfaceEdges(0, 1));
+}
+
+pair_map<double>
+getScores(const vb &vertex_sets,
+          const vusi &edges,
+          const std::function<double(const base::dynamic_bitset<> &, const base::dynamic_bitset<> &,
+                                     const vusi &)> &score_function,
+          const pair_map<double> &prev_scores) {
+
+    pair_map<double> result;
+    result.reserve(prev_scores.size());
+    for (const auto &pair : prev_scores)
+        result[pair.first] = score_function(vertex_sets[pair.first.first], vertex_sets[pair.first.second], edges);
+    return result;
+}
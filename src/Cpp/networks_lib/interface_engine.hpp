@@ -0,0 +1,86 @@
+#ifndef PROTEOFORMNETWORKS_INTERFACE_ENGINE_HPP
+#define PROTEOFORMNETWORKS_INTERFACE_ENGINE_HPP
+
+#include <functional>
+#include <utility>
+#include <vector>
+#include "csr.hpp"
+#include "module_sets.hpp"
+#include "overlap_types.hpp"
+#include "types.hpp"
+
+enum class InterfaceMeasure {
+    nodes, edges
+};
+
+// Interface sizes between pairs of modules of one level, from data computed once per module:
+// - the neighborhood bitset: vertices with a neighbor in the module,
+// - the incident edges: each edge with at least one end in the module, once, as (smaller, larger) set index.
+// For a pair (A, B), with N(X) the neighborhood of X and D the vertices with some edge:
+// - interface nodes: |(A & N(B)) | (B & N(A)) | (A & B & D)|, the members with an edge into the other module and
+//   the overlap members with any edge. It is a blocked OR and popcount over the block range of the two modules.
+// - interface edges: the edges touching A | B except the ones inside A - B or inside B - A, counted walking the
+//   incident edges of both modules with one bit test per end.
+// The sets are bitsets over the level, where bit i is the vertex first_vertex + i of the adjacency. Edges to
+// vertices outside the level are ignored. The sets must outlive the engine and must not change meanwhile.
+class InterfaceEngine {
+
+    ModuleSets module_sets;
+    base::dynamic_bitset<> has_edges;
+    vb neighborhoods;
+    std::vector<std::vector<std::pair<int, int>>> incident_edges;
+
+public:
+
+    // The per module data is computed in parallel by num_threads workers (0 uses all hardware threads).
+    InterfaceEngine(const vb &sets, const CSRAdjacency &adjacency, int first_vertex = 0, int num_threads = 0);
+
+    // The engine refers to the sets, so they can not be a temporary
+    InterfaceEngine(vb &&sets, const CSRAdjacency &adjacency, int first_vertex = 0, int num_threads = 0) = delete;
+
+    [[nodiscard]] std::size_t size() const { return module_sets.size(); }
+
+    [[nodiscard]] const base::dynamic_bitset<> &getNeighborhood(std::size_t module) const {
+        return neighborhoods[module];
+    }
+
+    [[nodiscard]] const std::vector<std::pair<int, int>> &getIncidentEdges(std::size_t module) const {
+        return incident_edges[module];
+    }
+
+    [[nodiscard]] std::size_t countInterfaceNodes(std::size_t module1, std::size_t module2) const;
+
+    [[nodiscard]] std::size_t countInterfaceEdges(std::size_t module1, std::size_t module2) const;
+
+    [[nodiscard]] std::size_t countInterface(std::size_t module1, std::size_t module2, InterfaceMeasure measure) const {
+        return measure == InterfaceMeasure::nodes ? countInterfaceNodes(module1, module2)
+                                                  : countInterfaceEdges(module1, module2);
+    }
+};
+
+// Interface size of every pair of the previous scores, for example the overlapping pairs, computed in parallel by
+// num_threads workers (0 uses all hardware threads). All the pairs are kept, also the ones with an empty interface.
+pair_map<double> getScores(const InterfaceEngine &engine, InterfaceMeasure measure, const pair_map<double> &prev_scores,
+                           int num_threads = 0);
+
+// Slow compatibility shims for the callers of the former per pair functions. Each call copies the two sets and
+// converts the whole adjacency list to CSR before counting, so it costs O(V + E) per pair. For more than a few
+// pairs, build one InterfaceEngine and call getScores.
+double calculate_interface_size_nodes(const base::dynamic_bitset<> &V1,
+                                      const base::dynamic_bitset<> &V2,
+                                      const vusi &E);
+
+double calculate_interface_size_edges(const base::dynamic_bitset<> &V1,
+                                      const base::dynamic_bitset<> &V2,
+                                      const vusi &E);
+
+// Score of every pair of the previous scores with a function of the two sets and the adjacency list, one pair after
+// the other. Compatibility shim like the per pair functions.
+pair_map<double>
+getScores(const vb &vertex_sets,
+          const vusi &edges,
+          const std::function<double(const base::dynamic_bitset<> &, const base::dynamic_bitset<> &,
+                                     const vusi &)> &score_function,
+          const pair_map<double> &prev_scores);
+
+#endif //PROTEOFORMNETWORKS_INTERFACE_ENGINE_HPP
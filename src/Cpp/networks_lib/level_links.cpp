@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include "level_links.hpp"
+#include "parallel.hpp"
+
+namespace {
+
+    using block_type = base::dynamic_bitset<>::block_type;
+    constexpr std::size_t BLOCK_BITS = base::bit_size<block_type>();
+
+    inline block_type getBit(const block_type *blocks, int index) {
+        return (blocks[index / BLOCK_BITS] >> (index % BLOCK_BITS)) & 1u;
+    }
+
+    // Compressed rows of the pairs (row, column), with sorted unique columns
+    void buildRows(std::vector<std::pair<int, int>> &pairs, int num_rows, int column_start, std::vector<int> &offsets,
+                   std::vector<int> &columns) {
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        offsets.assign(num_rows + 1, 0);
+        columns.clear();
+        columns.reserve(pairs.size());
+        for (const auto &[row, column] : pairs) {
+            offsets[row + 1]++;
+            columns.push_back(column_start + column);
+        }
+        for (int row = 0; row < num_rows; row++)
+            offsets[row + 1] += offsets[row];
+    }
+
+    std::size_t setSize(const base::dynamic_bitset<> &set) { return set.size(); }
+
+    std::size_t setSize(const HybridSet &set) { return set.universeSize(); }
+
+    template<typename F>
+    void visitMembers(const base::dynamic_bitset<> &set, F &&f) {
+        set.visit_set([&](auto member) { f(static_cast<int>(member)); });
+    }
+
+    template<typename F>
+    void visitMembers(const HybridSet &set, F &&f) { set.visit(f); }
+}
+
+LevelLinks::LevelLinks(const Interactome &interactome, Level parent_level, Level child_level,
+                       const std::map<int, std::vector<int>> &parent_to_children) :
+        child_level(child_level),
+        parent_start(interactome.getStartIndex(parent_level)),
+        child_start(interactome.getStartIndex(child_level)),
+        single_parent(true) {
+    const int num_parents = interactome.getEndIndex(parent_level) - parent_start + 1;
+    const int num_children = interactome.getEndIndex(child_level) - child_start + 1;
+
+    std::vector<std::pair<int, int>> links;     // (local parent, local child)
+    for (const auto &[parent, parent_children] : parent_to_children) {
+        if (!interactome.isInLevel(parent, parent_level))
+            continue;
+        for (int child : parent_children)
+            if (interactome.isInLevel(child, child_level))
+                links.emplace_back(parent - parent_start, child - child_start);
+    }
+    buildRows(links, num_parents, child_start, child_offsets, children);
+
+    for (auto &[parent, child] : links)
+        std::swap(parent, child);
+    buildRows(links, num_children, parent_start, parent_offsets, parents);
+
+    parent_of.assign(num_children, -1);
+    for (int child = 0; child < num_children; child++) {
+        if (parent_offsets[child + 1] > parent_offsets[child])
+            parent_of[child] = parents[parent_offsets[child]] - parent_start;
+        single_parent &= parent_offsets[child + 1] - parent_offsets[child] <= 1;
+    }
+}
+
+// Sparse sets scatter their members to the parents. Denser sets gather, for each block of parents, whether any child
+// of each parent is in the set.
+base::dynamic_bitset<> LevelLinks::lift(const base::dynamic_bitset<> &child_set) const {
+    if (child_set.size() != static_cast<std::size_t>(numChildren()))
+        throw std::invalid_argument("The set to lift has " + std::to_string(child_set.size()) + " bits but the level has "
+                                    + std::to_string(numChildren()) + " entities.");
+    base::dynamic_bitset<> result(numParents());
+    if (child_set.count() * 4 < static_cast<std::size_t>(numParents())) {
+        child_set.visit_set([&](auto child) {
+            for (int parent : getParents(child_start + static_cast<int>(child)))
+                result[parent - parent_start].set();
+        });
+        return result;
+    }
+
+    const block_type *set_blocks = child_set.block_begin();
+    block_type *result_blocks = result.block_begin();
+    for (std::size_t block = 0; block < result.blocks(); block++) {
+        const int first = static_cast<int>(block * BLOCK_BITS);
+        const int last = std::min(first + static_cast<int>(BLOCK_BITS), numParents());
+        block_type word = 0;
+        for (int parent = first; parent < last; parent++) {
+            block_type bit = 0;
+            for (int position = child_offsets[parent]; position < child_offsets[parent + 1]; position++)
+                bit |= getBit(set_blocks, children[position] - child_start);
+            word |= bit << (parent - first);
+        }
+        result_blocks[block] = word;
+    }
+    return result;
+}
+
+// Every block of children gathers the bits of their parents. With one parent per child this is a plain indexed load
+// per bit, without branches.
+base::dynamic_bitset<> LevelLinks::expand(const base::dynamic_bitset<> &parent_set) const {
+    if (parent_set.size() != static_cast<std::size_t>(numParents()))
+        throw std::invalid_argument("The set to expand has " + std::to_string(parent_set.size())
+                                    + " bits but the level has " + std::to_string(numParents()) + " entities.");
+    base::dynamic_bitset<> result(numChildren());
+    const block_type *set_blocks = parent_set.block_begin();
+    block_type *result_blocks = result.block_begin();
+
+    for (std::size_t block = 0; block < result.blocks(); block++) {
+        const int first = static_cast<int>(block * BLOCK_BITS);
+        const int last = std::min(first + static_cast<int>(BLOCK_BITS), numChildren());
+        block_type word = 0;
+        if (single_parent) {
+            for (int child = first; child < last; child++) {
+                const int parent = parent_of[child];
+                word |= (parent >= 0 ? getBit(set_blocks, parent) : 0u) << (child - first);
+            }
+        } else {
+            for (int child = first; child < last; child++) {
+                block_type bit = 0;
+                for (int position = parent_offsets[child]; position < parent_offsets[child + 1]; position++)
+                    bit |= getBit(set_blocks, parents[position] - parent_start);
+                word |= bit << (child - first);
+            }
+        }
+        result_blocks[block] = word;
+    }
+    return result;
+}
+
+base::dynamic_bitset<> LevelLinks::expand(const HybridSet &parent_set) const {
+    if (parent_set.universeSize() != static_cast<std::size_t>(numParents()))
+        throw std::invalid_argument("The set to expand has " + std::to_string(parent_set.universeSize())
+                                    + " bits but the level has " + std::to_string(numParents()) + " entities.");
+    base::dynamic_bitset<> result(numChildren());
+    parent_set.visit([&](int parent) {
+        for (int child : getChildren(parent_start + parent))
+            result[child - child_start].set();
+    });
+    return result;
+}
+
+template<typename Sets>
+void LevelLinks::projectBatch(const Sets &sets, std::size_t first, std::size_t count, std::size_t source_size,
+                              const std::vector<int> &offsets, const std::vector<int> &sources, int source_start,
+                              vb &result) {
+    std::vector<std::uint64_t> source_words(source_size, 0);
+    for (std::size_t module = 0; module < count; module++) {
+        if (setSize(sets[first + module]) != source_size)
+            throw std::invalid_argument("The set to project has " + std::to_string(setSize(sets[first + module]))
+                                        + " bits but the level has " + std::to_string(source_size) + " entities.");
+        visitMembers(sets[first + module], [&](int entity) { source_words[entity] |= std::uint64_t(1) << module; });
+    }
+
+    const std::size_t target_size = offsets.size() - 1;
+    for (std::size_t target = 0; target < target_size; target++) {
+        std::uint64_t word = 0;
+        for (int position = offsets[target]; position < offsets[target + 1]; position++)
+            word |= source_words[sources[position] - source_start];
+        while (word) {
+            result[first + std::countr_zero(word)][target].set();
+            word &= word - 1;
+        }
+    }
+}
+
+vb LevelLinks::lift(const vb &child_sets, int num_threads) const {
+    vb result(child_sets.size(), base::dynamic_bitset<>(numParents()));
+    const std::size_t num_batches = (child_sets.size() + 63) / 64;
+    parallelFor(num_batches, [&](std::size_t batch, int) {
+        projectBatch(child_sets, batch * 64, std::min<std::size_t>(64, child_sets.size() - batch * 64), numChildren(),
+                     child_offsets, children, child_start, result);
+    }, num_threads);
+    return result;
+}
+
+vb LevelLinks::expand(const vb &parent_sets, int num_threads) const {
+    vb result(parent_sets.size(), base::dynamic_bitset<>(numChildren()));
+    const std::size_t num_batches = (parent_sets.size() + 63) / 64;
+    parallelFor(num_batches, [&](std::size_t batch, int) {
+        projectBatch(parent_sets, batch * 64, std::min<std::size_t>(64, parent_sets.size() - batch * 64), numParents(),
+                     parent_offsets, parents, parent_start, result);
+    }, num_threads);
+    return result;
+}
+
+vb LevelLinks::expand(const std::vector<HybridSet> &parent_sets, int num_threads) const {
+    vb result(parent_sets.size(), base::dynamic_bitset<>(numChildren()));
+    const std::size_t num_batches = (parent_sets.size() + 63) / 64;
+    parallelFor(num_batches, [&](std::size_t batch, int) {
+        projectBatch(parent_sets, batch * 64, std::min<std::size_t>(64, parent_sets.size() - batch * 64), numParents(),
+                     parent_offsets, parents, parent_start, result);
+    }, num_threads);
+    return result;
+}
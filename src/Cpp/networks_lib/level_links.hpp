@@ -0,0 +1,89 @@
+#ifndef PROTEOFORMNETWORKS_LEVEL_LINKS_HPP
+#define PROTEOFORMNETWORKS_LEVEL_LINKS_HPP
+
+#include <map>
+#include <span>
+#include <vector>
+#include "../base/bitset.h"
+#include "hybrid_set.hpp"
+#include "Interactome.hpp"
+#include "types.hpp"
+
+// Integer links between the entities of a level and their products at the next level, for example genes and their
+// proteins, or proteins and their proteoforms. Built once from the interactome ranges and the mapping, so projecting
+// a set between levels does not touch names.
+// Nodes are interactome indexes. Sets are bitsets over the level, where bit i is the node start index + i, as in the
+// module bitsets.
+class LevelLinks {
+
+    Level child_level;
+    int parent_start;
+    int child_start;
+    std::vector<int> parent_of;              // Parent of each child (local index), or -1. The first one if several.
+    bool single_parent;                      // No child has more than one parent
+    std::vector<int> child_offsets;          // Children of parent p are children[child_offsets[p], child_offsets[p+1])
+    std::vector<int> children;               // Interactome indexes
+    std::vector<int> parent_offsets;         // Parents of child c are parents[parent_offsets[c], parent_offsets[c+1])
+    std::vector<int> parents;                // Interactome indexes
+
+    // Projects the sets [first, first + count) with count <= 64, bit sliced: word e has bit m set when set
+    // first + m has entity e. Each target word is the OR of the words of its sources in the CSR rows.
+    template<typename Sets>
+    static void projectBatch(const Sets &sets, std::size_t first, std::size_t count, std::size_t source_size,
+                             const std::vector<int> &offsets, const std::vector<int> &sources, int source_start,
+                             vb &result);
+
+public:
+
+    // The mapping goes from parent to children nodes. Nodes outside the ranges of the levels are ignored.
+    LevelLinks(const Interactome &interactome, Level parent_level, Level child_level,
+               const std::map<int, std::vector<int>> &parent_to_children);
+
+    [[nodiscard]] Level getChildLevel() const { return child_level; }
+
+    [[nodiscard]] int getChildStart() const { return child_start; }
+
+    [[nodiscard]] int numParents() const { return static_cast<int>(child_offsets.size()) - 1; }
+
+    [[nodiscard]] int numChildren() const { return static_cast<int>(parent_of.size()); }
+
+    // Parent node of the child node, or -1 when it has none.
+    [[nodiscard]] int getParent(int child) const {
+        const int parent = parent_of[child - child_start];
+        return parent < 0 ? -1 : parent_start + parent;
+    }
+
+    // Sorted children nodes of the parent node.
+    [[nodiscard]] std::span<const int> getChildren(int parent) const {
+        const int local = parent - parent_start;
+        return {children.data() + child_offsets[local], children.data() + child_offsets[local + 1]};
+    }
+
+    // Sorted parent nodes of the child node.
+    [[nodiscard]] std::span<const int> getParents(int child) const {
+        const int local = child - child_start;
+        return {parents.data() + parent_offsets[local], parents.data() + parent_offsets[local + 1]};
+    }
+
+    // Parents with at least one child in the set, e.g. the proteins of a proteoform set.
+    // Throws std::invalid_argument when the set is not over the child level.
+    [[nodiscard]] base::dynamic_bitset<> lift(const base::dynamic_bitset<> &child_set) const;
+
+    // All children of the parents in the set, e.g. all the proteoforms of a protein set.
+    // Throws std::invalid_argument when the set is not over the parent level.
+    [[nodiscard]] base::dynamic_bitset<> expand(const base::dynamic_bitset<> &parent_set) const;
+
+    // Same for a parent set kept as a hybrid set, for example the vertices of a module. The members scatter to their
+    // children, so the cost follows the size of the set.
+    [[nodiscard]] base::dynamic_bitset<> expand(const HybridSet &parent_set) const;
+
+    // Lift and expand of many sets at once. The sets are processed 64 per pass in a bit sliced layout, so each pass
+    // is one sweep over the links; the passes run on num_threads workers (0 uses all hardware threads).
+    [[nodiscard]] vb lift(const vb &child_sets, int num_threads = 0) const;
+
+    [[nodiscard]] vb expand(const vb &parent_sets, int num_threads = 0) const;
+
+    [[nodiscard]] vb expand(const std::vector<HybridSet> &parent_sets, int num_threads = 0) const;
+};
+
+#endif //PROTEOFORMNETWORKS_LEVEL_LINKS_HPP
@@ -0,0 +1,89 @@
+#include <stdexcept>
+#include <string>
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+   #define WIN32_LEAN_AND_MEAN
+   #include <windows.h>
+#else
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+#endif
+
+MappedFile::MappedFile(std::string_view file_path) : data_begin(nullptr), data_size(0) {
+    std::string path(file_path);
+    std::string message = "Cannot map file " + path + " at ";
+    std::string function = __FUNCTION__;
+
+#ifdef _WIN32
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    mapping_handle = nullptr;
+    if (file_handle == INVALID_HANDLE_VALUE)
+        throw std::runtime_error(message + function);
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        CloseHandle(file_handle);
+        throw std::runtime_error(message + function);
+    }
+    data_size = static_cast<std::size_t>(file_size.QuadPart);
+    if (data_size == 0)
+        return;
+
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        CloseHandle(file_handle);
+        throw std::runtime_error(message + function);
+    }
+    data_begin = static_cast<const std::byte *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (data_begin == nullptr) {
+        CloseHandle(mapping_handle);
+        CloseHandle(file_handle);
+        throw std::runtime_error(message + function);
+    }
+#else
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        throw std::runtime_error(message + function);
+
+    struct stat status{};
+    if (fstat(descriptor, &status) != 0) {
+        close(descriptor);
+        throw std::runtime_error(message + function);
+    }
+    data_size = static_cast<std::size_t>(status.st_size);
+    if (data_size == 0) {
+        close(descriptor);
+        return;
+    }
+
+    void *address = mmap(nullptr, data_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);  // The mapping stays valid after closing the descriptor
+    if (address == MAP_FAILED)
+        throw std::runtime_error(message + function);
+    data_begin = static_cast<const std::byte *>(address);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+void MappedFile::unmap() {
+#ifdef _WIN32
+    if (data_begin != nullptr)
+        UnmapViewOfFile(data_begin);
+    if (mapping_handle != nullptr)
+        CloseHandle(mapping_handle);
+    if (file_handle != INVALID_HANDLE_VALUE)
+        CloseHandle(file_handle);
+#else
+    if (data_begin != nullptr)
+        munmap(const_cast<std::byte *>(data_begin), data_size);
+#endif
+    data_begin = nullptr;
+    data_size = 0;
+}
@@ -0,0 +1,35 @@
+#ifndef PROTEOFORMNETWORKS_MAPPED_FILE_HPP
+#define PROTEOFORMNETWORKS_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string_view>
+
+// Read-only memory mapping of a whole file.
+// Several processes mapping the same file share the physical pages.
+class MappedFile {
+
+    const std::byte *data_begin;
+    std::size_t data_size;
+#ifdef _WIN32
+    void *file_handle;
+    void *mapping_handle;
+#endif
+
+    void unmap();
+
+public:
+
+    explicit MappedFile(std::string_view file_path);
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    [[nodiscard]] const std::byte *data() const { return data_begin; }
+
+    [[nodiscard]] std::size_t size() const { return data_size; }
+};
+
+#endif //PROTEOFORMNETWORKS_MAPPED_FILE_HPP
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "module_distances.hpp"
+#include "parallel.hpp"
+
+ModuleDistances::ModuleDistances(const MultiSourceBFS &bfs, const vb &sets, int num_threads) :
+        num_modules(sets.size()),
+        sizes(sets.size()),
+        within_distances(sets.size(), std::numeric_limits<double>::quiet_NaN()),
+        distance_sums(sets.size() * sets.size(), 0),
+        reached_counts(sets.size() * sets.size(), 0) {
+
+    const int num_vertices = bfs.numVertices();
+    for (const auto &set : sets)
+        if (set.size() != static_cast<std::size_t>(num_vertices))
+            throw std::invalid_argument("Module set size does not match the vertices of the multi source BFS");
+
+    // Modules of each vertex, and the members of all the modules
+    std::vector<int> module_offsets(num_vertices + 1, 0);
+    for (std::size_t module = 0; module < num_modules; module++) {
+        sizes[module] = sets[module].count();
+        sets[module].visit_set([&](auto member) { module_offsets[member + 1]++; });
+    }
+    std::vector<int> members;
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+        if (module_offsets[vertex + 1] > 0)
+            members.push_back(vertex);
+        module_offsets[vertex + 1] += module_offsets[vertex];
+    }
+    std::vector<int> vertex_modules(module_offsets.back());
+    std::vector<int> next(module_offsets.begin(), module_offsets.end() - 1);
+    for (std::size_t module = 0; module < num_modules; module++)
+        sets[module].visit_set([&](auto member) { vertex_modules[next[member]++] = static_cast<int>(module); });
+
+    // Distance from the members to the modules. Each batch of module sets owns its columns of the sums.
+    const std::size_t num_set_batches = (num_modules + MultiSourceBFS::MAX_SOURCES - 1) / MultiSourceBFS::MAX_SOURCES;
+    parallelFor(num_set_batches, [&](std::size_t batch, int) {
+        const std::size_t first = batch * MultiSourceBFS::MAX_SOURCES;
+        const std::size_t count = std::min(MultiSourceBFS::MAX_SOURCES, num_modules - first);
+        bfs.traverseSets(std::span(sets).subspan(first, count),
+                         [&](int vertex, int distance, std::span<const std::uint64_t> mask) {
+            if (module_offsets[vertex] == module_offsets[vertex + 1])
+                return;
+            MultiSourceBFS::forEachSource(mask, [&](std::size_t source) {
+                const std::size_t module2 = first + source;
+                for (int J = module_offsets[vertex]; J < module_offsets[vertex + 1]; J++) {
+                    const std::size_t entry = vertex_modules[J] * num_modules + module2;
+                    distance_sums[entry] += distance;
+                    reached_counts[entry]++;
+                }
+            });
+        });
+    }, num_threads);
+
+    // Distance from each member to the nearest other member of each of its modules. Each batch of members owns
+    // their entries in nearest.
+    std::vector<std::uint8_t> nearest(vertex_modules.size(), MultiSourceBFS::UNREACHABLE);
+    const std::size_t num_member_batches = (members.size() + MultiSourceBFS::MAX_SOURCES - 1)
+                                           / MultiSourceBFS::MAX_SOURCES;
+    parallelFor(num_member_batches, [&](std::size_t batch, int) {
+        const std::size_t first = batch * MultiSourceBFS::MAX_SOURCES;
+        auto sources = std::span(members).subspan(first, std::min(MultiSourceBFS::MAX_SOURCES, members.size() - first));
+        bfs.traverse(sources, [&](int vertex, int distance, std::span<const std::uint64_t> mask) {
+            if (distance == 0 || module_offsets[vertex] == module_offsets[vertex + 1])
+                return;
+            MultiSourceBFS::forEachSource(mask, [&](std::size_t source) {
+                // Shared modules of the source and the vertex, merging their sorted module lists
+                const int member = sources[source];
+                int J = module_offsets[member], K = module_offsets[vertex];
+                while (J < module_offsets[member + 1] && K < module_offsets[vertex + 1]) {
+                    if (vertex_modules[J] < vertex_modules[K]) {
+                        J++;
+                    } else if (vertex_modules[K] < vertex_modules[J]) {
+                        K++;
+                    } else {
+                        // The first visit is at the smallest distance
+                        if (nearest[J] == MultiSourceBFS::UNREACHABLE)
+                            nearest[J] = static_cast<std::uint8_t>(distance);
+                        J++;
+                        K++;
+                    }
+                }
+            });
+        });
+    }, num_threads);
+
+    std::vector<std::uint64_t> within_sums(num_modules, 0);
+    std::vector<std::size_t> within_counts(num_modules, 0);
+    for (std::size_t J = 0; J < vertex_modules.size(); J++) {
+        if (nearest[J] != MultiSourceBFS::UNREACHABLE) {
+            within_sums[vertex_modules[J]] += nearest[J];
+            within_counts[vertex_modules[J]]++;
+        }
+    }
+    for (std::size_t module = 0; module < num_modules; module++)
+        if (within_counts[module] > 0)
+            within_distances[module] = static_cast<double>(within_sums[module]) / within_counts[module];
+}
+
+ModuleDistances::ModuleDistances(const DistanceMatrix &matrix, const vb &sets, int num_threads) :
+        num_modules(sets.size()),
+        sizes(sets.size()),
+        within_distances(sets.size(), std::numeric_limits<double>::quiet_NaN()),
+        distance_sums(sets.size() * sets.size(), 0),
+        reached_counts(sets.size() * sets.size(), 0) {
+
+    std::vector<std::vector<int>> members(num_modules);
+    for (std::size_t module = 0; module < num_modules; module++) {
+        if (sets[module].size() != static_cast<std::size_t>(matrix.numVertices()))
+            throw std::invalid_argument("Module set size does not match the vertices of the distance matrix");
+        sets[module].visit_set([&](auto member) { members[module].push_back(static_cast<int>(member)); });
+        sizes[module] = members[module].size();
+    }
+
+    // Each task owns the row of its module in the sums
+    parallelFor(num_modules, [&](std::size_t module1, int) {
+        std::uint64_t within_sum = 0;
+        std::size_t within_count = 0;
+        for (int member : members[module1]) {
+            auto row = matrix.getRow(matrix.getFirstVertex() + member);
+            for (std::size_t module2 = 0; module2 < num_modules; module2++) {
+                std::uint8_t distance = DistanceMatrix::UNREACHABLE;
+                for (int other : members[module2])
+                    if (module2 != module1 || other != member)
+                        distance = std::min(distance, row[other]);
+                if (distance == DistanceMatrix::UNREACHABLE)
+                    continue;
+                if (module2 == module1) {
+                    within_sum += distance;
+                    within_count++;
+                } else {
+                    distance_sums[module1 * num_modules + module2] += distance;
+                    reached_counts[module1 * num_modules + module2]++;
+                }
+            }
+        }
+        if (within_count > 0)
+            within_distances[module1] = static_cast<double>(within_sum) / within_count;
+    }, num_threads);
+}
+
+double ModuleDistances::getShortestDistance(std::size_t module1, std::size_t module2) const {
+    const std::size_t entry12 = module1 * num_modules + module2, entry21 = module2 * num_modules + module1;
+    const std::size_t count = reached_counts[entry12] + reached_counts[entry21];
+    if (count == 0)
+        return std::numeric_limits<double>::quiet_NaN();
+    return static_cast<double>(distance_sums[entry12] + distance_sums[entry21]) / count;
+}
+
+double ModuleDistances::getSeparation(std::size_t module1, std::size_t module2) const {
+    return getShortestDistance(module1, module2)
+           - (getWithinDistance(module1) + getWithinDistance(module2)) / 2.0;
+}
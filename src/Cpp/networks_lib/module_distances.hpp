@@ -0,0 +1,95 @@
+#ifndef PROTEOFORMNETWORKS_MODULE_DISTANCES_HPP
+#define PROTEOFORMNETWORKS_MODULE_DISTANCES_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "distance_matrix.hpp"
+#include "multi_source_bfs.hpp"
+#include "overlap_types.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
+#include "types.hpp"
+
+enum class ModuleDistance {
+    shortest,       // <d_AB>
+    separation      // s_AB = <d_AB> - (<d_AA> + <d_BB>) / 2
+};
+
+// Shortest path distances within and between the modules of one level, as in the network separation of disease
+// modules:
+// - <d_AA>: mean over the members a of A of the distance from a to the nearest other member of A.
+// - <d_AB>: mean over the members of A and B of the distance to the nearest member of the other module, which is 0
+//   for the members in both.
+// Members that do not reach the other members are left out of the means. A mean without members is NaN.
+// The distances from every vertex to the modules come from multi source BFS with one source bit per module set, so
+// 512 modules share each traversal. The within module distances need one source per member, also in batches of 512.
+// With a precomputed distance matrix the distances are read from its rows instead, one task per module.
+// The sums of distances between modules are kept in a dense modules x modules matrix.
+class ModuleDistances {
+
+    std::size_t num_modules;
+    std::vector<std::size_t> sizes;
+    std::vector<double> within_distances;
+    std::vector<std::uint64_t> distance_sums;        // Row A, column B: sum over a in A of the distance from a to B
+    std::vector<std::uint32_t> reached_counts;       // Row A, column B: members of A that reach B
+
+public:
+
+    // The sets are bitsets over the vertices of the BFS. The traversals run on num_threads workers (0 uses all
+    // hardware threads). Throws std::invalid_argument for sets of another size.
+    ModuleDistances(const MultiSourceBFS &bfs, const vb &sets, int num_threads = 0);
+
+    // The sets are bitsets over the vertices of the matrix. The modules are processed in parallel by num_threads
+    // workers (0 uses all hardware threads). Throws std::invalid_argument for sets of another size.
+    ModuleDistances(const DistanceMatrix &matrix, const vb &sets, int num_threads = 0);
+
+    [[nodiscard]] std::size_t size() const { return num_modules; }
+
+    [[nodiscard]] std::size_t numMembers(std::size_t module) const { return sizes[module]; }
+
+    // <d_AA>
+    [[nodiscard]] double getWithinDistance(std::size_t module) const { return within_distances[module]; }
+
+    // <d_AB>
+    [[nodiscard]] double getShortestDistance(std::size_t module1, std::size_t module2) const;
+
+    // s_AB. Negative when the modules overlap or are closer than their members among themselves.
+    [[nodiscard]] double getSeparation(std::size_t module1, std::size_t module2) const;
+
+    [[nodiscard]] double getDistance(std::size_t module1, std::size_t module2, ModuleDistance measure) const {
+        return measure == ModuleDistance::shortest ? getShortestDistance(module1, module2)
+                                                   : getSeparation(module1, module2);
+    }
+};
+
+// Distance between every pair of modules within the sizes, the mean shortest distance or the separation. Unlike the
+// set scores, zero and negative values are stored; only the pairs without a defined distance are left out.
+// The rows of the pair matrix are computed in parallel by num_threads workers (0 uses all hardware threads).
+template<typename R = pair_map<double>>
+R getScores(const ModuleDistances &distances, ModuleDistance measure, const int min_module_size,
+            const int max_module_size, int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(distances.size(), 1).finish();
+    std::vector<int> selected;
+    for (std::size_t module = 0; module < distances.size(); module++)
+        if (static_cast<std::size_t>(std::max(min_module_size, 0)) <= distances.numMembers(module)
+            && distances.numMembers(module) <= static_cast<std::size_t>(max_module_size))
+            selected.push_back(static_cast<int>(module));
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<R> collector(distances.size(), num_threads);
+    parallelFor(selected.size(), [&](std::size_t row, int worker) {
+        for (std::size_t column = row + 1; column < selected.size(); column++) {
+            const double distance = distances.getDistance(selected[row], selected[column], measure);
+            if (!std::isnan(distance))
+                collector.store(worker, selected[row], selected[column], distance);
+        }
+    }, num_threads);
+
+    return collector.finish();
+}
+
+#endif //PROTEOFORMNETWORKS_MODULE_DISTANCES_HPP
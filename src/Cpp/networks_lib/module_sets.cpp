@@ -0,0 +1,36 @@
+#include <algorithm>
+#include "module_sets.hpp"
+
+ModuleSets::ModuleSets(const vb &sets) :
+        sets(sets),
+        cardinalities(sets.size()),
+        first_blocks(sets.size()),
+        end_blocks(sets.size()) {
+
+    for (std::size_t I = 0; I < sets.size(); I++) {
+        const auto begin = sets[I].block_begin(), end = sets[I].block_end();
+        auto first = std::find_if(begin, end, [](auto block) { return block != 0; });
+        if (first == end) {     // Empty sets get an empty range, so they never intersect
+            first_blocks[I] = end_blocks[I] = 0;
+            continue;
+        }
+        auto last = std::find_if(std::make_reverse_iterator(end), std::make_reverse_iterator(first),
+                                 [](auto block) { return block != 0; });
+        first_blocks[I] = first - begin;
+        end_blocks[I] = last.base() - begin;
+        for (auto block = first; block != last.base(); block++)
+            cardinalities[I] += base::popcount(*block);
+    }
+}
+
+std::vector<int> ModuleSets::select(std::size_t min_size, std::size_t max_size) const {
+    std::vector<int> selected;
+    for (std::size_t I = 0; I < sets.size(); I++)
+        if (min_size <= cardinalities[I] && cardinalities[I] <= max_size)
+            selected.push_back(static_cast<int>(I));
+
+    std::stable_sort(selected.begin(), selected.end(), [this](int index1, int index2) {
+        return cardinalities[index1] < cardinalities[index2];
+    });
+    return selected;
+}
@@ -0,0 +1,45 @@
+#ifndef PROTEOFORMNETWORKS_MODULE_SETS_HPP
+#define PROTEOFORMNETWORKS_MODULE_SETS_HPP
+
+#include <vector>
+#include "types.hpp"
+
+// Vertex sets of a collection of modules, with the cardinality and the range of non-empty blocks of every set
+// calculated once at construction.
+// It refers to the sets, so the vb must outlive it and must not change meanwhile.
+class ModuleSets {
+
+    const vb &sets;
+    std::vector<std::size_t> cardinalities;
+    std::vector<std::size_t> first_blocks;  // First block with a set bit
+    std::vector<std::size_t> end_blocks;    // One past the last block with a set bit
+
+public:
+
+    explicit ModuleSets(const vb &sets);
+
+    // A temporary vb would be destroyed while the ModuleSets still refers to it
+    ModuleSets(vb &&sets) = delete;
+
+    [[nodiscard]] std::size_t size() const { return sets.size(); }
+
+    [[nodiscard]] const vb &getSets() const { return sets; }
+
+    const base::dynamic_bitset<> &operator[](std::size_t index) const { return sets[index]; }
+
+    [[nodiscard]] std::size_t cardinality(std::size_t index) const { return cardinalities[index]; }
+
+    [[nodiscard]] std::size_t firstBlock(std::size_t index) const { return first_blocks[index]; }
+
+    [[nodiscard]] std::size_t endBlock(std::size_t index) const { return end_blocks[index]; }
+
+    // False when the two sets can not share any member: one is empty or their block ranges do not meet.
+    [[nodiscard]] bool mayIntersect(std::size_t index1, std::size_t index2) const {
+        return first_blocks[index1] < end_blocks[index2] && first_blocks[index2] < end_blocks[index1];
+    }
+
+    // Indexes of the sets with min_size <= cardinality <= max_size, sorted by cardinality, then by index.
+    [[nodiscard]] std::vector<int> select(std::size_t min_size, std::size_t max_size) const;
+};
+
+#endif //PROTEOFORMNETWORKS_MODULE_SETS_HPP
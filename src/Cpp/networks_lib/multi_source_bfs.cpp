@@ -0,0 +1,70 @@
+#include <algorithm>
+#include "multi_source_bfs.hpp"
+#include "parallel.hpp"
+
+namespace {
+
+// Runs the sources in batches of MultiSourceBFS::MAX_SOURCES in parallel, calling task(batch, batch_sources).
+template<typename F>
+void forEachBatch(std::span<const int> sources, F &&task, int num_threads) {
+    const std::size_t num_batches = (sources.size() + MultiSourceBFS::MAX_SOURCES - 1) / MultiSourceBFS::MAX_SOURCES;
+    parallelFor(num_batches, [&](std::size_t batch, int) {
+        const std::size_t first = batch * MultiSourceBFS::MAX_SOURCES;
+        task(first, sources.subspan(first, std::min(MultiSourceBFS::MAX_SOURCES, sources.size() - first)));
+    }, num_threads);
+}
+
+}
+
+MultiSourceBFS::MultiSourceBFS(const CSRAdjacency &adjacency, int first_vertex, int end_vertex) {
+    if (end_vertex < 0 || end_vertex > adjacency.numVertices())
+        end_vertex = adjacency.numVertices();
+    first_vertex = std::max(first_vertex, 0);
+    const int num_vertices = std::max(end_vertex - first_vertex, 0);
+
+    offsets.assign(num_vertices + 1, 0);
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+        // The neighbors are sorted, so the ones in the range are a slice
+        auto row = adjacency.getNeighbors(first_vertex + vertex);
+        auto begin = std::lower_bound(row.begin(), row.end(), first_vertex);
+        auto end = std::lower_bound(begin, row.end(), end_vertex);
+        for (auto neighbor = begin; neighbor != end; neighbor++)
+            neighbors.push_back(*neighbor - first_vertex);
+        offsets[vertex + 1] = static_cast<int>(neighbors.size());
+    }
+}
+
+MultiSourceBFS::MultiSourceBFS(const Interactome &interactome, Level level) :
+        MultiSourceBFS(interactome.getAdjacency(), interactome.getStartIndex(level),
+                       interactome.getEndIndex(level) + 1) {}
+
+std::vector<std::vector<std::uint8_t>> MultiSourceBFS::getDistanceRows(std::span<const int> sources,
+                                                                       int num_threads) const {
+    std::vector<std::vector<std::uint8_t>> rows(sources.size());
+    forEachBatch(sources, [&](std::size_t first, std::span<const int> batch) {
+        for (std::size_t source = first; source < first + batch.size(); source++)
+            rows[source].assign(numVertices(), UNREACHABLE);
+        traverse(batch, [&](int vertex, int distance, std::span<const std::uint64_t> mask) {
+            forEachSource(mask, [&](std::size_t source) {
+                rows[first + source][vertex] = static_cast<std::uint8_t>(distance);
+            });
+        });
+    }, num_threads);
+    return rows;
+}
+
+std::vector<std::vector<std::size_t>> MultiSourceBFS::getDistanceHistograms(std::span<const int> sources,
+                                                                            int num_threads) const {
+    std::vector<std::vector<std::size_t>> histograms(sources.size());
+    forEachBatch(sources, [&](std::size_t first, std::span<const int> batch) {
+        traverse(batch, [&](int, int distance, std::span<const std::uint64_t> mask) {
+            forEachSource(mask, [&](std::size_t source) {
+                auto &histogram = histograms[first + source];
+                if (histogram.size() <= static_cast<std::size_t>(distance))
+                    histogram.resize(distance + 1, 0);
+                histogram[distance]++;
+            });
+        });
+    }, num_threads);
+    return histograms;
+}
@@ -0,0 +1,161 @@
+#ifndef PROTEOFORMNETWORKS_MULTI_SOURCE_BFS_HPP
+#define PROTEOFORMNETWORKS_MULTI_SOURCE_BFS_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "../base/bitset.h"
+#include "csr.hpp"
+#include "Interactome.hpp"
+#include "types.hpp"
+
+// Breadth first searches from up to MAX_SOURCES sources at once, with one bit per source in the masks of each
+// vertex: the seen mask has the sources that already reached the vertex, the frontier mask the sources that reached
+// it in the last level. A level ORs the frontier of every vertex into its neighbors and keeps the new bits, so all
+// the searches share one pass over the adjacency. The masks have 1, 2, 4 or 8 words of 64 bits, the fewest that fit
+// the sources.
+// The searches run on a copy of the adjacency restricted to a range of vertices, for example one level of the
+// interactome. Vertices and sources are indexes inside the range: vertex i is first_vertex + i of the adjacency.
+class MultiSourceBFS {
+
+    std::vector<int> offsets;      // Neighbors of vertex v in neighbors[offsets[v], offsets[v + 1])
+    std::vector<int> neighbors;
+
+    // seed(mark) calls mark(vertex, source) for the vertices at distance 0 of each source.
+    template<std::size_t WORDS, typename S, typename F>
+    void traverseWords(S &seed, F &visit, int max_distance) const;
+
+    template<typename S, typename F>
+    void traverseSeeds(std::size_t num_sources, S seed, F &visit, int max_distance) const {
+        if (num_sources > MAX_SOURCES)
+            throw std::invalid_argument("Too many sources for one multi source BFS");
+        const std::size_t words = (num_sources + 63) / 64;
+        if (words <= 1)
+            traverseWords<1>(seed, visit, max_distance);
+        else if (words <= 2)
+            traverseWords<2>(seed, visit, max_distance);
+        else if (words <= 4)
+            traverseWords<4>(seed, visit, max_distance);
+        else
+            traverseWords<8>(seed, visit, max_distance);
+    }
+
+public:
+
+    static constexpr std::size_t MAX_SOURCES = 512;
+    // Distance in the distance rows of the vertices not reached
+    static constexpr std::uint8_t UNREACHABLE = 255;
+
+    // Keeps the vertices [first_vertex, end_vertex) and the edges between them. end_vertex -1 is the last vertex.
+    explicit MultiSourceBFS(const CSRAdjacency &adjacency, int first_vertex = 0, int end_vertex = -1);
+
+    // Keeps the nodes of the level and the interactions between them.
+    MultiSourceBFS(const Interactome &interactome, Level level);
+
+    [[nodiscard]] int numVertices() const { return static_cast<int>(offsets.size()) - 1; }
+
+    // Calls visit(vertex, distance, mask) once per vertex and distance at which some source reaches it for the first
+    // time, in increasing order of distance, up to max_distance. Bit s of the mask (a span of 64 bit words) is set
+    // for the sources[s] that reach it at that distance. Throws std::invalid_argument for more than MAX_SOURCES
+    // sources or sources outside the vertices.
+    template<typename F>
+    void traverse(std::span<const int> sources, F &&visit, int max_distance = UNREACHABLE - 1) const {
+        for (int source : sources)
+            if (source < 0 || source >= numVertices())
+                throw std::invalid_argument("Source outside the vertices of the multi source BFS");
+        traverseSeeds(sources.size(), [&](auto &&mark) {
+            for (std::size_t source = 0; source < sources.size(); source++)
+                mark(sources[source], source);
+        }, visit, max_distance);
+    }
+
+    // Like traverse, with bit s of the masks for the set sets[s]: the distance from a vertex to a set is the distance
+    // to its nearest member. The sets are bitsets over the vertices. Throws std::invalid_argument for more than
+    // MAX_SOURCES sets or sets of another size.
+    template<typename F>
+    void traverseSets(std::span<const base::dynamic_bitset<>> sets, F &&visit,
+                      int max_distance = UNREACHABLE - 1) const {
+        for (const auto &set : sets)
+            if (set.size() != static_cast<std::size_t>(numVertices()))
+                throw std::invalid_argument("Source set size does not match the vertices of the multi source BFS");
+        traverseSeeds(sets.size(), [&](auto &&mark) {
+            for (std::size_t source = 0; source < sets.size(); source++)
+                sets[source].visit_set([&](auto member) { mark(static_cast<int>(member), source); });
+        }, visit, max_distance);
+    }
+
+    // Calls f(s) for every source s set in a mask of the traversals.
+    template<typename F>
+    static void forEachSource(std::span<const std::uint64_t> mask, F &&f) {
+        for (std::size_t word = 0; word < mask.size(); word++)
+            for (std::uint64_t bits = mask[word]; bits != 0; bits &= bits - 1)
+                f(word * 64 + std::countr_zero(bits));
+    }
+
+    // Row s has the distance from sources[s] to every vertex, or UNREACHABLE. Distances above UNREACHABLE - 1 are
+    // not followed. Any number of sources is accepted: they are split in batches of MAX_SOURCES, which run in
+    // parallel on num_threads workers (0 uses all hardware threads).
+    [[nodiscard]] std::vector<std::vector<std::uint8_t>> getDistanceRows(std::span<const int> sources,
+                                                                        int num_threads = 0) const;
+
+    // Histogram s has at index d the number of vertices at distance d from sources[s], up to the farthest vertex
+    // reached. Batched and parallel like getDistanceRows.
+    [[nodiscard]] std::vector<std::vector<std::size_t>> getDistanceHistograms(std::span<const int> sources,
+                                                                             int num_threads = 0) const;
+};
+
+template<std::size_t WORDS, typename S, typename F>
+void MultiSourceBFS::traverseWords(S &seed, F &visit, int max_distance) const {
+    using mask = std::array<std::uint64_t, WORDS>;
+    auto is_empty = [](const mask &m) {
+        std::uint64_t any = 0;
+        for (auto word : m)
+            any |= word;
+        return any == 0;
+    };
+
+    const int num_vertices = numVertices();
+    std::vector<mask> seen(num_vertices), frontier(num_vertices), next(num_vertices);
+    seed([&](int vertex, std::size_t source) {
+        frontier[vertex][source / 64] |= std::uint64_t(1) << (source % 64);
+    });
+    for (int vertex = 0; vertex < num_vertices; vertex++) {
+        if (!is_empty(frontier[vertex])) {
+            seen[vertex] = frontier[vertex];
+            visit(vertex, 0, std::span<const std::uint64_t>(frontier[vertex]));
+        }
+    }
+
+    for (int distance = 1; distance <= max_distance; distance++) {
+        for (int vertex = 0; vertex < num_vertices; vertex++) {
+            if (is_empty(frontier[vertex]))
+                continue;
+            for (int J = offsets[vertex]; J < offsets[vertex + 1]; J++) {
+                auto &target = next[neighbors[J]];
+                for (std::size_t word = 0; word < WORDS; word++)
+                    target[word] |= frontier[vertex][word];
+            }
+        }
+
+        // The new bits become the frontier of the next level
+        bool reached = false;
+        for (int vertex = 0; vertex < num_vertices; vertex++) {
+            for (std::size_t word = 0; word < WORDS; word++) {
+                frontier[vertex][word] = next[vertex][word] & ~seen[vertex][word];
+                seen[vertex][word] |= frontier[vertex][word];
+                next[vertex][word] = 0;
+            }
+            if (!is_empty(frontier[vertex])) {
+                reached = true;
+                visit(vertex, distance, std::span<const std::uint64_t>(frontier[vertex]));
+            }
+        }
+        if (!reached)
+            break;
+    }
+}
+
+#endif //PROTEOFORMNETWORKS_MULTI_SOURCE_BFS_HPP
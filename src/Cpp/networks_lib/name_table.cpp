@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "name_table.hpp"
+
+NameTable::NameTable() : block_used(0), block_capacity(0), arena_size(0), slots(16, -1) {
+
+}
+
+NameTable::NameTable(const NameTable &other) : NameTable() {
+    std::size_t num_characters = 0;
+    for (auto name : other.names)
+        num_characters += name.size();
+    reserve(other.names.size(), num_characters);
+    for (auto name : other.names)
+        intern(name);
+    // The names keep their indexes and hashes, so the perfect hash of the other table is valid for the copy
+    perfect_hash = other.perfect_hash;
+}
+
+NameTable &NameTable::operator=(const NameTable &other) {
+    if (this != &other)
+        *this = NameTable(other);
+    return *this;
+}
+
+// The standard string hash, with the high bits mixed into the low bits used for the slot
+std::uint64_t NameTable::hash(std::string_view name) {
+    std::uint64_t h = std::hash<std::string_view>{}(name);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+std::size_t NameTable::findSlot(std::string_view name, std::uint64_t name_hash) const {
+    const std::size_t mask = slots.size() - 1;
+    std::size_t slot = name_hash & mask;
+    while (slots[slot] >= 0) {
+        const int index = slots[slot];
+        if (hashes[index] == name_hash && names[index] == name)
+            return slot;
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+std::string_view NameTable::store(std::string_view name) {
+    if (name.empty())
+        return {};
+    if (block_used + name.size() > block_capacity) {
+        block_capacity = std::max(BLOCK_SIZE, name.size());
+        blocks.push_back(std::make_unique<char[]>(block_capacity));
+        block_used = 0;
+        arena_size += block_capacity;
+    }
+    char *begin = blocks.back().get() + block_used;
+    std::memcpy(begin, name.data(), name.size());
+    block_used += name.size();
+    return {begin, name.size()};
+}
+
+void NameTable::grow(std::size_t num_slots) {
+    slots.assign(num_slots, -1);
+    const std::size_t mask = num_slots - 1;
+    for (int index = 0; index < size(); index++) {
+        std::size_t slot = hashes[index] & mask;
+        while (slots[slot] >= 0)
+            slot = (slot + 1) & mask;
+        slots[slot] = index;
+    }
+}
+
+void NameTable::reserve(std::size_t num_names, std::size_t num_characters) {
+    names.reserve(num_names);
+    hashes.reserve(num_names);
+    std::size_t num_slots = slots.size();
+    while (num_slots < 2 * num_names)
+        num_slots *= 2;
+    if (num_slots != slots.size())
+        grow(num_slots);
+    if (num_characters > block_capacity - block_used) {
+        block_capacity = std::max(BLOCK_SIZE, num_characters);
+        blocks.push_back(std::make_unique<char[]>(block_capacity));
+        block_used = 0;
+        arena_size += block_capacity;
+    }
+}
+
+int NameTable::intern(std::string_view name) {
+    if (slots.empty())      // Moved from
+        grow(16);
+    const std::uint64_t name_hash = hash(name);
+    std::size_t slot = findSlot(name, name_hash);
+    if (slots[slot] >= 0)
+        return slots[slot];
+
+    perfect_hash = PerfectHash();
+    const int index = size();
+    names.push_back(store(name));
+    hashes.push_back(name_hash);
+    slots[slot] = index;
+    if (2 * names.size() > slots.size())    // Keep the load factor at most 1/2
+        grow(2 * slots.size());
+    return index;
+}
+
+bool NameTable::buildPerfectHash() {
+    return perfect_hash.build(hashes);
+}
+
+int NameTable::find(std::string_view name) const {
+    if (!perfect_hash.empty()) {
+        const std::uint64_t name_hash = hash(name);
+        const int index = perfect_hash.find(name_hash);
+        return hashes[index] == name_hash && names[index] == name ? index : -1;
+    }
+    if (slots.empty())
+        return -1;
+    return slots[findSlot(name, hash(name))];
+}
+
+std::size_t NameTable::getMemoryUsage() const {
+    return arena_size + names.capacity() * sizeof(std::string_view) + hashes.capacity() * sizeof(std::uint64_t)
+           + slots.capacity() * sizeof(int) + perfect_hash.getMemoryUsage();
+}
@@ -0,0 +1,80 @@
+#ifndef PROTEOFORMNETWORKS_NAME_TABLE_HPP
+#define PROTEOFORMNETWORKS_NAME_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+#include "perfect_hash.hpp"
+
+// Table of unique names, each identified by the order in which it was added.
+// The characters of all names are stored once, back to back, in large arena blocks that never move, so the
+// string_view handles stay valid for the life of the table. Lookup by name goes through a flat open addressing hash
+// of name indexes with linear probing; the hash of every name is kept so growing the table does not rehash strings.
+// Once the names are final, buildPerfectHash replaces the probing by a minimal perfect hash: a lookup reads one slot
+// and compares one name. Adding a name afterwards drops the perfect hash and goes back to probing.
+class NameTable {
+
+    static constexpr std::size_t BLOCK_SIZE = std::size_t(1) << 16;
+
+    std::vector<std::unique_ptr<char[]>> blocks;
+    std::size_t block_used;                // Characters used in the last block
+    std::size_t block_capacity;            // Characters in the last block
+    std::size_t arena_size;                // Characters in all blocks
+
+    std::vector<std::string_view> names;
+    std::vector<std::uint64_t> hashes;
+    std::vector<int> slots;                // Name index or -1, the size is a power of 2
+    PerfectHash perfect_hash;
+
+    static std::uint64_t hash(std::string_view name);
+
+    [[nodiscard]] std::size_t findSlot(std::string_view name, std::uint64_t name_hash) const;
+
+    std::string_view store(std::string_view name);
+
+    void grow(std::size_t num_slots);
+
+public:
+
+    NameTable();
+
+    // Copies are compacted into a single arena block and keep the perfect hash.
+    NameTable(const NameTable &other);
+
+    NameTable &operator=(const NameTable &other);
+
+    NameTable(NameTable &&) noexcept = default;
+
+    NameTable &operator=(NameTable &&) noexcept = default;
+
+    // Makes room for the names without growing again, and for their characters in one block.
+    void reserve(std::size_t num_names, std::size_t num_characters = 0);
+
+    // Index of the name, adding it at the end if it is new.
+    int intern(std::string_view name);
+
+    // Builds the perfect hash over the current names. Returns false, and keeps probing, in the unlikely case that two
+    // names have the same 64-bit hash.
+    bool buildPerfectHash();
+
+    [[nodiscard]] bool hasPerfectHash() const { return !perfect_hash.empty(); }
+
+    // Index of the name, or -1 when it is not in the table.
+    [[nodiscard]] int find(std::string_view name) const;
+
+    [[nodiscard]] bool contains(std::string_view name) const { return find(name) >= 0; }
+
+    [[nodiscard]] std::string_view operator[](int index) const { return names[index]; }
+
+    [[nodiscard]] int size() const { return static_cast<int>(names.size()); }
+
+    [[nodiscard]] bool empty() const { return names.empty(); }
+
+    [[nodiscard]] const std::vector<std::string_view> &getNames() const { return names; }
+
+    // Bytes held by the arena, handles and hash table.
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+};
+
+#endif //PROTEOFORMNETWORKS_NAME_TABLE_HPP
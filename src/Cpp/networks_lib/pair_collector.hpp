@@ -0,0 +1,59 @@
+#ifndef PROTEOFORMNETWORKS_PAIR_COLLECTOR_HPP
+#define PROTEOFORMNETWORKS_PAIR_COLLECTOR_HPP
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "../base/memory.h"
+#include "overlap_types.hpp"
+#include "pair_map.hpp"
+
+// Collects the scores found by parallel workers into the result container chosen by the caller:
+// - pair_map<double>: each worker fills its own map and the maps are merged at the end.
+// - TriangularPairMap<double>: the workers write their pairs directly into the shared triangle and count the new
+//   pairs on their own, so the size is added once at the end.
+template<typename R>
+class PairCollector {
+    std::vector<R> partial_results;
+
+public:
+    PairCollector(std::size_t, int num_threads) : partial_results(num_threads) {}
+
+    void store(int worker, int index1, int index2, double score) {
+        partial_results[worker][std::make_pair(index1, index2)] = score;
+    }
+
+    R finish() {
+        R result = std::move(partial_results[0]);
+        for (std::size_t worker = 1; worker < partial_results.size(); worker++)
+            result.insert(partial_results[worker].begin(), partial_results[worker].end());
+        return result;
+    }
+};
+
+template<>
+class PairCollector<TriangularPairMap<double>> {
+    struct alignas(base::cacheline_byte_size) Counter {
+        std::size_t new_pairs = 0;
+    };
+
+    TriangularPairMap<double> result;
+    std::vector<Counter> counters;
+
+public:
+    PairCollector(std::size_t num_modules, int num_threads) : result(num_modules), counters(num_threads) {}
+
+    void store(int worker, int index1, int index2, double score) {
+        const std::size_t pair = result.position(index1, index2);
+        counters[worker].new_pairs += result.mark(pair);
+        result.values[pair] = score;
+    }
+
+    TriangularPairMap<double> finish() {
+        for (const auto &counter : counters)
+            result.num_present += counter.new_pairs;
+        return std::move(result);
+    }
+};
+
+#endif //PROTEOFORMNETWORKS_PAIR_COLLECTOR_HPP
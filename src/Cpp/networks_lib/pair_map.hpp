@@ -0,0 +1,256 @@
+#ifndef PROTEOFORMNETWORKS_PAIR_MAP_HPP
+#define PROTEOFORMNETWORKS_PAIR_MAP_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Flat hash map from pairs of non-negative ints to values.
+// The pair is packed in one 64-bit key, mixed with the splitmix64 finalizer, so (i, j) and (j, i) and the pairs of
+// small indexes spread over the whole table. The keys are probed linearly in an array of their own, with a load
+// factor of at most 1/2. The entries are kept densely in insertion order: iterating visits only the stored pairs, and
+// a hit touches the key array and its entry. Entries can not be erased.
+template<typename T>
+class PairMap {
+
+public:
+
+    using key_type = std::pair<int, int>;
+    using mapped_type = T;
+    using value_type = std::pair<const key_type, T>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+private:
+
+    static constexpr std::uint64_t EMPTY = ~std::uint64_t(0);
+
+    std::vector<value_type> entries;
+    std::vector<std::uint64_t> slot_keys;       // Packed key or EMPTY, the size is a power of 2
+    std::vector<std::uint32_t> slot_entries;    // Position of the entry of each slot
+
+    static std::uint64_t pack(const key_type &key) {
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.first)) << 32
+               | static_cast<std::uint32_t>(key.second);
+    }
+
+    static std::uint64_t mix(std::uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    // Slot of the key, or the empty slot where it would go
+    [[nodiscard]] std::size_t findSlot(std::uint64_t packed) const {
+        const std::size_t mask = slot_keys.size() - 1;
+        std::size_t slot = mix(packed) & mask;
+        while (slot_keys[slot] != EMPTY && slot_keys[slot] != packed)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void rehash(std::size_t num_slots) {
+        slot_keys.assign(num_slots, EMPTY);
+        slot_entries.assign(num_slots, 0);
+        for (std::size_t entry = 0; entry < entries.size(); entry++) {
+            const std::uint64_t packed = pack(entries[entry].first);
+            const std::size_t slot = findSlot(packed);
+            slot_keys[slot] = packed;
+            slot_entries[slot] = static_cast<std::uint32_t>(entry);
+        }
+    }
+
+    // Entry of the key, adding it with the value if it is new
+    template<typename V>
+    std::pair<iterator, bool> insertEntry(const key_type &key, V &&value) {
+        if (slot_keys.empty())
+            rehash(16);
+        const std::uint64_t packed = pack(key);
+        std::size_t slot = findSlot(packed);
+        if (slot_keys[slot] == packed)
+            return {entries.begin() + slot_entries[slot], false};
+
+        slot_keys[slot] = packed;
+        slot_entries[slot] = static_cast<std::uint32_t>(entries.size());
+        entries.emplace_back(key, std::forward<V>(value));
+        if (2 * entries.size() > slot_keys.size())    // Keep the load factor at most 1/2
+            rehash(2 * slot_keys.size());
+        return {entries.end() - 1, true};
+    }
+
+public:
+
+    PairMap() = default;
+
+    // Makes room for the pairs without rehashing.
+    void reserve(std::size_t num_pairs) {
+        entries.reserve(num_pairs);
+        std::size_t num_slots = std::max<std::size_t>(slot_keys.size(), 16);
+        while (num_slots < 2 * num_pairs)
+            num_slots *= 2;
+        if (num_slots != slot_keys.size())
+            rehash(num_slots);
+    }
+
+    [[nodiscard]] std::size_t size() const { return entries.size(); }
+
+    [[nodiscard]] bool empty() const { return entries.empty(); }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    T &operator[](const key_type &key) { return insertEntry(key, T()).first->second; }
+
+    std::pair<iterator, bool> insert(const value_type &value) { return insertEntry(value.first, value.second); }
+
+    // Adds the pairs that are not in the map yet.
+    template<typename It>
+    void insert(It first, It last) {
+        for (; first != last; ++first)
+            insertEntry(first->first, first->second);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> emplace(const key_type &key, Args &&... args) {
+        return insertEntry(key, T(std::forward<Args>(args)...));
+    }
+
+    [[nodiscard]] const_iterator find(const key_type &key) const {
+        if (slot_keys.empty())
+            return entries.end();
+        const std::uint64_t packed = pack(key);
+        const std::size_t slot = findSlot(packed);
+        return slot_keys[slot] == packed ? entries.begin() + slot_entries[slot] : entries.end();
+    }
+
+    iterator find(const key_type &key) {
+        auto it = static_cast<const PairMap &>(*this).find(key);
+        return entries.begin() + (it - entries.cbegin());
+    }
+
+    [[nodiscard]] std::size_t count(const key_type &key) const { return find(key) != end(); }
+
+    [[nodiscard]] bool contains(const key_type &key) const { return find(key) != end(); }
+
+    // Throws std::out_of_range when the pair is not in the map.
+    [[nodiscard]] const T &at(const key_type &key) const {
+        auto it = find(key);
+        if (it == end())
+            throw std::out_of_range("Pair (" + std::to_string(key.first) + ", " + std::to_string(key.second)
+                                    + ") is not in the map.");
+        return it->second;
+    }
+
+    T &at(const key_type &key) { return const_cast<T &>(static_cast<const PairMap &>(*this).at(key)); }
+
+    // Bytes held by the entries and the slots.
+    [[nodiscard]] std::size_t getMemoryUsage() const {
+        return entries.capacity() * sizeof(value_type)
+               + slot_keys.capacity() * (sizeof(std::uint64_t) + sizeof(std::uint32_t));
+    }
+
+    // Same pairs with the same values, in any order.
+    friend bool operator==(const PairMap &map1, const PairMap &map2) {
+        if (map1.size() != map2.size())
+            return false;
+        for (const auto &[key, value] : map1) {
+            auto it = map2.find(key);
+            if (it == map2.end() || !(it->second == value))
+                return false;
+        }
+        return true;
+    }
+};
+
+template<typename R>
+class PairCollector;
+
+// Values of all the pairs (i, j) with i < j < num_modules in one array, for results where most pairs are present.
+// The pair (i, j) is at j (j - 1) / 2 + i. A byte per pair marks the pairs that were set, so any value, also T(), can
+// be stored, and the number of set pairs is kept as they are set.
+// Different pairs are different elements, so workers can set their own pairs without locking. Only the count is
+// shared: concurrent writers go through PairCollector, which counts the new pairs of each worker and adds them at the
+// end.
+template<typename T>
+class TriangularPairMap {
+
+    std::size_t num_modules;
+    std::vector<T> values;
+    std::vector<std::uint8_t> present;
+    std::size_t num_present = 0;
+
+    friend class PairCollector<TriangularPairMap<T>>;
+
+    [[nodiscard]] std::size_t position(int index1, int index2) const {
+        if (index1 > index2)
+            std::swap(index1, index2);
+        if (index1 < 0 || index1 == index2 || static_cast<std::size_t>(index2) >= num_modules)
+            throw std::out_of_range("Pair (" + std::to_string(index1) + ", " + std::to_string(index2)
+                                    + ") is not in the triangle of " + std::to_string(num_modules) + " modules.");
+        return static_cast<std::size_t>(index2) * (index2 - 1) / 2 + index1;
+    }
+
+    // Marks the pair as set without counting it. Returns true if it was not set before.
+    bool mark(std::size_t position) {
+        if (present[position])
+            return false;
+        present[position] = 1;
+        return true;
+    }
+
+public:
+
+    explicit TriangularPairMap(std::size_t num_modules) :
+            num_modules(num_modules),
+            values(num_modules < 2 ? 0 : num_modules * (num_modules - 1) / 2),
+            present(values.size(), 0) {
+    }
+
+    [[nodiscard]] std::size_t numModules() const { return num_modules; }
+
+    // Sets the pair. The order of the indexes does not matter.
+    T &operator[](const std::pair<int, int> &key) {
+        const std::size_t pair = position(key.first, key.second);
+        num_present += mark(pair);
+        return values[pair];
+    }
+
+    // Value of the pair, or T() if it was never set.
+    [[nodiscard]] const T &operator()(int index1, int index2) const { return values[position(index1, index2)]; }
+
+    [[nodiscard]] bool contains(const std::pair<int, int> &key) const {
+        return present[position(key.first, key.second)];
+    }
+
+    // Number of set pairs.
+    [[nodiscard]] std::size_t size() const { return num_present; }
+
+    [[nodiscard]] bool empty() const { return num_present == 0; }
+
+    // Calls f(index1, index2, value) for every set pair, with index1 < index2.
+    template<typename F>
+    void forEach(F &&f) const {
+        std::size_t position = 0;
+        for (std::size_t index2 = 1; index2 < num_modules; index2++)
+            for (std::size_t index1 = 0; index1 < index2; index1++, position++)
+                if (present[position])
+                    f(static_cast<int>(index1), static_cast<int>(index2), values[position]);
+    }
+
+    [[nodiscard]] PairMap<T> toPairMap() const {
+        PairMap<T> result;
+        result.reserve(num_present);
+        forEach([&](int index1, int index2, const T &value) { result[{index1, index2}] = value; });
+        return result;
+    }
+};
+
+#endif //PROTEOFORMNETWORKS_PAIR_MAP_HPP
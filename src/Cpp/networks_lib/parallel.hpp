@@ -0,0 +1,103 @@
+#ifndef PROTEOFORMNETWORKS_PARALLEL_HPP
+#define PROTEOFORMNETWORKS_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../base/memory.h"
+
+// Number of worker threads used when the caller passes 0.
+inline int defaultNumThreads() {
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+// Runs task(task_index, worker_index) for every task index in [0, num_tasks) on num_threads workers.
+// Each worker starts with a contiguous slice of the tasks and takes them from the front. A worker that runs out
+// steals the back half of the slice of another worker, so uneven tasks (like the tiles of a triangular matrix)
+// keep all workers busy.
+// The worker index lets tasks write into per-worker results without locking.
+// The first exception thrown by a task is rethrown after all workers stop.
+template<typename F>
+void parallelFor(std::size_t num_tasks, F &&task, int num_threads = 0) {
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    num_threads = static_cast<int>(std::min<std::size_t>(num_threads, std::max<std::size_t>(num_tasks, 1)));
+
+    if (num_threads == 1) {
+        for (std::size_t task_index = 0; task_index < num_tasks; task_index++)
+            task(task_index, 0);
+        return;
+    }
+
+    struct alignas(base::cacheline_byte_size) Slice {
+        std::mutex mutex;
+        std::size_t begin = 0;
+        std::size_t end = 0;
+    };
+
+    std::vector<Slice> slices(num_threads);
+    for (int worker = 0; worker < num_threads; worker++) {
+        slices[worker].begin = num_tasks * worker / num_threads;
+        slices[worker].end = num_tasks * (worker + 1) / num_threads;
+    }
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    auto take_own = [&](int worker, std::size_t &task_index) {
+        std::lock_guard<std::mutex> lock(slices[worker].mutex);
+        if (slices[worker].begin == slices[worker].end)
+            return false;
+        task_index = slices[worker].begin++;
+        return true;
+    };
+
+    auto steal = [&](int worker) {
+        for (int offset = 1; offset < num_threads; offset++) {
+            int victim = (worker + offset) % num_threads;
+            std::size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(slices[victim].mutex);
+                if (slices[victim].begin == slices[victim].end)
+                    continue;
+                begin = slices[victim].begin + (slices[victim].end - slices[victim].begin) / 2;
+                end = slices[victim].end;
+                slices[victim].end = begin;
+            }
+            std::lock_guard<std::mutex> lock(slices[worker].mutex);
+            slices[worker].begin = begin;
+            slices[worker].end = end;
+            return true;
+        }
+        return false;
+    };
+
+    auto work = [&](int worker) {
+        try {
+            std::size_t task_index;
+            do {
+                while (take_own(worker, task_index))
+                    task(task_index, worker);
+            } while (steal(worker));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int worker = 1; worker < num_threads; worker++)
+        threads.emplace_back(work, worker);
+    work(0);
+    for (auto &thread : threads)
+        thread.join();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+#endif //PROTEOFORMNETWORKS_PARALLEL_HPP
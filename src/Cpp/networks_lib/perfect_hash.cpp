@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "perfect_hash.hpp"
+
+bool PerfectHash::build(const std::vector<std::uint64_t> &key_hashes) {
+    bucket_seeds.clear();
+    slot_keys.clear();
+    const std::size_t num_keys = key_hashes.size();
+    if (num_keys == 0)
+        return true;
+
+    std::vector<std::uint64_t> sorted_hashes(key_hashes);
+    std::sort(sorted_hashes.begin(), sorted_hashes.end());
+    if (std::adjacent_find(sorted_hashes.begin(), sorted_hashes.end()) != sorted_hashes.end())
+        return false;
+
+    bucket_seeds.assign((num_keys + BUCKET_SIZE - 1) / BUCKET_SIZE, 0);
+    std::vector<std::vector<int>> buckets(bucket_seeds.size());
+    for (int key = 0; key < static_cast<int>(num_keys); key++)
+        buckets[bucketOf(key_hashes[key])].push_back(key);
+
+    std::vector<std::size_t> order(buckets.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t bucket1, std::size_t bucket2) {
+        return buckets[bucket1].size() > buckets[bucket2].size();
+    });
+
+    slot_keys.assign(num_keys, -1);
+    std::vector<std::size_t> slots;
+    std::size_t next_free = 0;      // Every slot before it is taken
+    for (std::size_t bucket : order) {
+        const auto &keys = buckets[bucket];
+        if (keys.empty())
+            break;
+
+        if (keys.size() == 1) {
+            while (slot_keys[next_free] >= 0)
+                next_free++;
+            slot_keys[next_free] = keys.front();
+            bucket_seeds[bucket] = -static_cast<std::int32_t>(next_free) - 1;
+            continue;
+        }
+
+        for (std::uint32_t seed = 0;; seed++) {
+            if (seed == static_cast<std::uint32_t>(INT32_MAX))
+                throw std::runtime_error("Could not place a bucket of the perfect hash.");
+            slots.clear();
+            bool placed = true;
+            for (int key : keys) {
+                std::size_t slot = mix(key_hashes[key], seed) % num_keys;
+                if (slot_keys[slot] >= 0 || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    placed = false;
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (placed) {
+                for (std::size_t I = 0; I < keys.size(); I++)
+                    slot_keys[slots[I]] = keys[I];
+                bucket_seeds[bucket] = static_cast<std::int32_t>(seed);
+                break;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,53 @@
+#ifndef PROTEOFORMNETWORKS_PERFECT_HASH_HPP
+#define PROTEOFORMNETWORKS_PERFECT_HASH_HPP
+
+#include <cstdint>
+#include <vector>
+
+// Minimal perfect hash over a fixed set of distinct 64-bit key hashes (hash and displace).
+// The keys are split in buckets of about BUCKET_SIZE keys. Starting with the largest buckets, each bucket gets the
+// first seed that sends all its keys to free slots; buckets of a single key store their slot directly. A lookup is
+// one read of the bucket seed and one mix, and lands on the only slot its key can be in.
+class PerfectHash {
+
+    static constexpr std::size_t BUCKET_SIZE = 4;
+
+    std::vector<std::int32_t> bucket_seeds;    // Seed, or -(slot + 1) for buckets placed directly
+    std::vector<int> slot_keys;                // Position of the key of each slot in the build input
+
+    [[nodiscard]] std::size_t bucketOf(std::uint64_t key_hash) const {
+        return static_cast<std::size_t>((key_hash >> 32) % bucket_seeds.size());
+    }
+
+    static std::uint64_t mix(std::uint64_t key_hash, std::uint32_t seed) {
+        std::uint64_t h = key_hash ^ (seed * 0x9e3779b97f4a7c15ULL);
+        h ^= h >> 31;
+        h *= 0xbf58476d1ce4e5b9ULL;
+        h ^= h >> 29;
+        return h;
+    }
+
+public:
+
+    PerfectHash() = default;
+
+    // Builds the hash for the keys. Returns false, leaving the hash empty, when two keys have the same hash.
+    bool build(const std::vector<std::uint64_t> &key_hashes);
+
+    [[nodiscard]] bool empty() const { return slot_keys.empty(); }
+
+    // Position in the build input of the only key that can have this hash. Keys outside the set land on an arbitrary
+    // key, so the caller compares them.
+    [[nodiscard]] int find(std::uint64_t key_hash) const {
+        const std::int32_t seed = bucket_seeds[bucketOf(key_hash)];
+        const std::size_t slot = seed < 0 ? static_cast<std::size_t>(-seed - 1)
+                                          : mix(key_hash, static_cast<std::uint32_t>(seed)) % slot_keys.size();
+        return slot_keys[slot];
+    }
+
+    [[nodiscard]] std::size_t getMemoryUsage() const {
+        return bucket_seeds.capacity() * sizeof(std::int32_t) + slot_keys.capacity() * sizeof(int);
+    }
+};
+
+#endif //PROTEOFORMNETWORKS_PERFECT_HASH_HPP
@@ -0,0 +1,12 @@
+#include "phegeni_reader.hpp"
+
+PheGenIReader::PheGenIReader(std::string_view file_phegeni) : file(file_phegeni) {
+
+}
+
+int PheGenIReader::internTrait(std::string_view trait) {
+    auto [entry, inserted] = trait_indexes.try_emplace(trait, static_cast<int>(trait_names.size()));
+    if (inserted)
+        trait_names.push_back(trait);
+    return entry->second;
+}
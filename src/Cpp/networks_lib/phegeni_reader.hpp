@@ -0,0 +1,107 @@
+#ifndef PROTEOFORMNETWORKS_PHEGENI_READER_HPP
+#define PROTEOFORMNETWORKS_PHEGENI_READER_HPP
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "mapped_file.hpp"
+
+// One row of the PheGenI association file. The views point into the mapped file.
+struct PheGenIAssociation {
+    int trait;                  // Interned trait index, see PheGenIReader::getTraitName
+    std::string_view gene;
+    std::string_view gene_2;
+    std::string_view p_value;
+};
+
+// Streaming reader of the PheGenI genome wide association file (tab separated, with a header line).
+// The file is mapped and each row is split in place into string_view fields, so reading allocates nothing per row.
+// Trait names are interned the first time they appear: rows carry a dense trait index and the names are views into
+// the mapping, valid while the reader lives.
+class PheGenIReader {
+
+public:
+
+    // Columns: #, Trait, SNP rs, Context, Gene, Gene ID, Gene 2, Gene ID 2, Chromosome, Location, P-Value, Source,
+    // PubMed, Analysis ID, Study ID, Study Name
+    static constexpr std::size_t TRAIT_COLUMN = 1;
+    static constexpr std::size_t GENE_COLUMN = 4;
+    static constexpr std::size_t GENE_2_COLUMN = 6;
+    static constexpr std::size_t P_VALUE_COLUMN = 10;
+    static constexpr std::size_t NUM_COLUMNS = 16;
+
+private:
+
+    MappedFile file;
+    std::vector<std::string_view> trait_names;
+    std::unordered_map<std::string_view, int> trait_indexes;
+
+    int internTrait(std::string_view trait);
+
+public:
+
+    explicit PheGenIReader(std::string_view file_phegeni);
+
+    // Calls f(const PheGenIAssociation &) for every row after the header, in file order.
+    // Throws std::runtime_error for rows with fewer than P_VALUE_COLUMN + 1 fields.
+    template<typename F>
+    void forEachAssociation(F &&f);
+
+    [[nodiscard]] std::size_t numTraits() const { return trait_names.size(); }
+
+    [[nodiscard]] std::string_view getTraitName(int trait) const { return trait_names[trait]; }
+
+    [[nodiscard]] std::size_t fileSize() const { return file.size(); }
+};
+
+// Splits the line [begin, end) at the tabs into fields. Returns the number of fields found, at most NUM_COLUMNS.
+inline std::size_t splitFields(const char *begin, const char *end,
+                               std::array<std::string_view, PheGenIReader::NUM_COLUMNS> &fields) {
+    std::size_t num_fields = 0;
+    while (num_fields < fields.size()) {
+        auto tab = static_cast<const char *>(std::memchr(begin, '\t', end - begin));
+        const char *field_end = tab ? tab : end;
+        fields[num_fields++] = std::string_view(begin, field_end - begin);
+        if (!tab)
+            break;
+        begin = tab + 1;
+    }
+    return num_fields;
+}
+
+template<typename F>
+void PheGenIReader::forEachAssociation(F &&f) {
+    const char *position = reinterpret_cast<const char *>(file.data());
+    const char *end = position + file.size();
+    std::array<std::string_view, NUM_COLUMNS> fields;
+    bool header = true;
+
+    while (position < end) {
+        auto newline = static_cast<const char *>(std::memchr(position, '\n', end - position));
+        const char *line_end = newline ? newline : end;
+        const char *next = newline ? newline + 1 : end;
+        if (line_end > position && line_end[-1] == '\r')
+            line_end--;
+
+        if (header || line_end == position) {  // Skip the header line and empty lines
+            header = false;
+            position = next;
+            continue;
+        }
+
+        if (splitFields(position, line_end, fields) <= P_VALUE_COLUMN) {
+            std::string message = "Missing columns in PheGenI row \"" + std::string(position, line_end) + "\" at ";
+            std::string function = __FUNCTION__;
+            throw std::runtime_error(message + function);
+        }
+        f(PheGenIAssociation{internTrait(fields[TRAIT_COLUMN]), fields[GENE_COLUMN], fields[GENE_2_COLUMN],
+                             fields[P_VALUE_COLUMN]});
+        position = next;
+    }
+}
+
+#endif //PROTEOFORMNETWORKS_PHEGENI_READER_HPP
@@ -0,0 +1,112 @@
+#include "proteoform.hpp"
+
+namespace proteoform {
+
+ProteoformParts parseProteoform(std::string_view proteoform) {
+    ProteoformParts parts;
+    const std::size_t accession_end = proteoform.find_first_of(";-");
+    parts.accession = proteoform.substr(0, accession_end);
+    if (accession_end == std::string_view::npos)
+        return parts;
+    const std::size_t modifications_start = proteoform.find(';', accession_end);
+    if (proteoform[accession_end] == '-')
+        parts.isoform = proteoform.substr(accession_end + 1, modifications_start - accession_end - 1);
+    if (modifications_start != std::string_view::npos)
+        parts.modifications = proteoform.substr(modifications_start + 1);
+    return parts;
+}
+
+std::string getAccession(const std::string &proteoform) {
+    return std::string(parseProteoform(proteoform).accession);
+}
+
+bool isModified(std::string_view proteoform) {
+    bool modified = false;
+    forEachModification(proteoform, [&](const Modification &) { modified = true; });
+    return modified;
+}
+
+vs getModifications(std::string_view proteoform) {
+    vs modifications;
+    forEachModification(proteoform, [&](const Modification &modification) {
+        modifications.emplace_back(modification.mod);
+    });
+    return modifications;
+}
+
+ProteoformTable::ProteoformTable(const vs &proteoforms) {
+    accessions.reserve(proteoforms.size());
+    isoforms.reserve(proteoforms.size());
+    modification_offsets.reserve(proteoforms.size() + 1);
+    modification_offsets.push_back(0);
+    for (const auto &proteoform : proteoforms) {
+        ProteoformParts parts = parseProteoform(proteoform);
+        accessions.push_back(parts.accession);
+        isoforms.push_back(parts.isoform);
+        forEachModification(proteoform, [&](const Modification &modification) {
+            modifications.push_back(modification);
+        });
+        modification_offsets.push_back(modifications.size());
+    }
+}
+
+std::string readProteoformFromNeo4jCsv(std::ifstream &fs) {
+    std::string proteoform;
+    if (fs.peek() == '\"')  // Read initial "
+        fs.get();
+    fs.get();  // Read initial " or [
+    getline(fs, proteoform, ']');
+
+    // Remove the extra ',' in the proteoform representation comming directly from Neo4j queries
+    std::size_t index = proteoform.find_first_of(',');
+    if (index != std::string::npos)
+        proteoform.erase(index, 1);
+    return proteoform;
+}
+
+vs readProteoforms(const std::string &path_file_mapping, bool hasHeader) {
+    std::ifstream map_file(path_file_mapping.data());
+    std::string entity, leftover;
+    uss temp_set;
+    vs index_to_entities;
+
+    if (!map_file.is_open()) {
+        throw std::runtime_error("Could not open file " + path_file_mapping);
+    }
+
+    if (hasHeader) {
+        getline(map_file, leftover);  // Skip header line
+    }
+    while (map_file.peek() != EOF) {
+        if (map_file.peek() == '[' || map_file.peek() == '\"') {
+            entity = proteoform::readProteoformFromNeo4jCsv(map_file);
+        }
+        else {
+            getline(map_file, entity, ',');  // Read entity
+        }
+        getline(map_file, leftover);  // Read rest of line
+        temp_set.insert(entity);
+    }
+    index_to_entities = convert_uss_to_vs(temp_set);
+
+    return index_to_entities;
+}
+
+const measures_result calculateModificationsPerProteoform(const vs &proteoforms) {
+    double min = 1.0;
+    double max = 0.0;
+    double avg = 0.0;
+    double sum = 0.0;
+    for (const auto &proteoform : proteoforms) {
+        double num = static_cast<double>(proteoform::getModifications(proteoform).size());
+        if (num < min)
+            min = num;
+        if (num > max)
+            max = num;
+        sum += num;
+    }
+    avg = sum / proteoforms.size();
+    return { min, max, avg };
+}
+
+}  // namespace proteoform
\ No newline at end of file
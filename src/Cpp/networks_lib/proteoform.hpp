@@ -0,0 +1,129 @@
+#ifndef PROTEOFORMNETWORKS_PROTEOFORM_HPP
+#define PROTEOFORMNETWORKS_PROTEOFORM_HPP
+
+#include <bitset>
+#include <charconv>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "bimap_str_int.hpp"
+#include "scores.hpp"
+#include "types.hpp"
+
+namespace proteoform {
+
+// Proteoforms in simple format are ACCESSION[-ISOFORM][;MOD:POSITION,MOD:POSITION,...], where MOD is a five digit
+// PSI-MOD identifier and POSITION is a number or "null".
+// The parser scans the string once and only returns views into it, so it does not allocate.
+
+// A modification of a proteoform. The position is -1 when it is unknown ("null").
+struct Modification {
+    std::string_view mod;
+    int position;
+};
+
+struct ProteoformParts {
+    std::string_view accession;
+    std::string_view isoform;         // Empty for the canonical sequence
+    std::string_view modifications;   // Text after the ';', empty when the proteoform is not modified
+};
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Splits the proteoform at the first '-' or ';'
+[[nodiscard]] ProteoformParts parseProteoform(std::string_view proteoform);
+
+// Calls f(Modification) for every five digit identifier after a ';' or a ','. Text after a delimiter that does not
+// start with five digits is not a modification and is skipped. A position that is neither a number nor "null", or
+// that is not followed by a ',' or the end of the proteoform, throws std::invalid_argument.
+template<typename F>
+void forEachModification(std::string_view proteoform, F &&f) {
+    const char *position = proteoform.data();
+    const char *end = position + proteoform.size();
+    for (; position < end; position++) {
+        if ((*position != ';' && *position != ',') || end - position <= 5)
+            continue;
+        const char *mod = position + 1;
+        if (!(isDigit(mod[0]) && isDigit(mod[1]) && isDigit(mod[2]) && isDigit(mod[3]) && isDigit(mod[4])))
+            continue;
+        int site = -1;
+        position = mod + 5;
+        if (position < end && *position == ':') {
+            position++;
+            if (std::string_view(position, end - position).starts_with("null")) {
+                position += 4;
+            } else {
+                auto [number_end, error] = std::from_chars(position, end, site);
+                if (error != std::errc())
+                    throw std::invalid_argument("Malformed position of modification in " + std::string(proteoform));
+                position = number_end;
+            }
+        }
+        if (position < end && *position != ',')
+            throw std::invalid_argument("Malformed modification in " + std::string(proteoform));
+        f(Modification{std::string_view(mod, 5), site});
+        position--;   // The loop steps to the ',' after the modification
+    }
+}
+
+// Method to get the accesion from a proteoform string in simple format
+std::string getAccession(const std::string &proteoform);
+
+// Method to verify if a proteoform has modifications
+bool isModified(std::string_view proteoform);
+
+template<size_t S>
+std::bitset<S> getSetOfModifiedProteoforms(const Bimap_str_int &proteoforms) {
+    std::bitset<S> modified_proteoforms;
+
+    for (int I = 0; I < proteoforms.size(); I++) {
+        if (isModified(proteoforms.name(I))) {
+            modified_proteoforms.set(I);
+        }
+    }
+
+    return modified_proteoforms;
+}
+
+vs getModifications(std::string_view proteoform);
+
+// Pre-parsed proteoforms, one column per part, indexed like the input vector.
+// The views point into the input strings, which must outlive the table.
+class ProteoformTable {
+    std::vector<std::string_view> accessions;
+    std::vector<std::string_view> isoforms;
+    std::vector<std::size_t> modification_offsets;   // Modifications of proteoform I are in [offsets[I], offsets[I + 1])
+    std::vector<Modification> modifications;
+
+public:
+    explicit ProteoformTable(const vs &proteoforms);
+
+    [[nodiscard]] std::size_t size() const { return accessions.size(); }
+
+    [[nodiscard]] std::string_view getAccession(std::size_t index) const { return accessions[index]; }
+
+    [[nodiscard]] std::string_view getIsoform(std::size_t index) const { return isoforms[index]; }
+
+    [[nodiscard]] bool isModified(std::size_t index) const {
+        return modification_offsets[index + 1] > modification_offsets[index];
+    }
+
+    [[nodiscard]] std::span<const Modification> getModifications(std::size_t index) const {
+        return {modifications.data() + modification_offsets[index],
+                modifications.data() + modification_offsets[index + 1]};
+    }
+};
+
+std::string readProteoformFromNeo4jCsv(std::ifstream &fs);
+
+// Reads the unique proteoforms of the first column of a csv file, sorted
+vs readProteoforms(const std::string &path_file_mapping, bool hasHeader);
+
+const measures_result calculateModificationsPerProteoform(const vs &proteoforms);
+
+} // namespace proteoform
+
+#endif //PROTEOFORMNETWORKS_PROTEOFORM_HPP
@@ -97,133 +97,78 @@ void writeMeasures(ofstream &report, const ummss &mapping, string_view label1, s
     writeMeasures(report, measures, label1, label2);
 }
 
-double getJaccardSimilarity(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2) {
-    if (set1.count() == 0 && set2.count() == 0) {
+double JaccardSimilarity::operator()(const base::overlap_count &counts) const {
+    if (counts.first == 0 && counts.second == 0) {
         return 1.0;
     } else {
-        double intersection_size = (set1 & set2).count();
-        double union_size = (set1 | set2).count();
-        return intersection_size / union_size;
+        return static_cast<double>(counts.intersection) / counts.union_size();
     }
 }
 
-double getOverlapSimilarity(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2) {
-    if (set1.count() == 0 || set2.count() == 0) {
+double JaccardSimilarity::upperBound(std::size_t size1, std::size_t size2) const {
+    if (size1 == 0 && size2 == 0)
+        return 1.0;
+    return static_cast<double>(std::min(size1, size2)) / std::max(size1, size2);
+}
+
+double JaccardSimilarity::operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const {
+    return (*this)(base::count_overlap(set1, set2));
+}
+
+double JaccardSimilarity::operator()(const HybridSet &set1, const HybridSet &set2) const {
+    return (*this)(countOverlap(set1, set2));
+}
+
+double OverlapSimilarity::operator()(const base::overlap_count &counts) const {
+    if (counts.first == 0 || counts.second == 0) {
         return 1.0;
     } else {
-        double intersection_size = (set1 & set2).count();
-        return intersection_size / min(set1.count(), set2.count());
+        return static_cast<double>(counts.intersection) / min(counts.first, counts.second);
     }
 }
 
-double getOverlapSize(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2) {
-    return (set1 & set2).count();
-}
-
-/*
- * Calculates the score for each pair of sets.
- * The calculation requires just the sets of vertices. No need for the edges.
- */
-pair_map<double> getScores(const vb &vertex_sets,
-                           std::function<double(base::dynamic_bitset<>,
-                                                base::dynamic_bitset<>)> score_function,
-                           const unsigned int min_module_size, const unsigned int max_module_size) {
-
-    pair_map<double> result;
-    for (auto I1 = 0u; I1 < vertex_sets.size(); I1++) {
-        if (vertex_sets[I1].count() < min_module_size || vertex_sets[I1].count() > max_module_size) continue;
-        for (auto I2 = I1 + 1; I2 < vertex_sets.size(); I2++) {
-            if (vertex_sets[I2].count() < min_module_size || vertex_sets[I2].count() > max_module_size) continue;
-            std::cerr << I1 << " -- " << I2 << std::endl;
-            auto score = score_function(vertex_sets[I1], vertex_sets[I2]);
-            if (score > 0)
-                result[make_pair(I1, I2)] = score;
-        }
-    }
+double OverlapSimilarity::upperBound(std::size_t, std::size_t) const {
+    return 1.0;
+}
 
-    return result;
+double OverlapSimilarity::operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const {
+    return (*this)(base::count_overlap(set1, set2));
 }
 
-pair_map<double> getScores(const vb &vertex_sets,
-                           std::function<double(base::dynamic_bitset<>,
-                                                base::dynamic_bitset<>)> score_function,
-                           const pair_map<double> &prev_scores) {
+double OverlapSimilarity::operator()(const HybridSet &set1, const HybridSet &set2) const {
+    return (*this)(countOverlap(set1, set2));
+}
 
-    pair_map<double> result;
-    for (const auto &pair : prev_scores) {
-//        std::cerr << "Try " << pair.first.first << " , " << pair.first.second << std::endl;
-        result[pair.first] = score_function(vertex_sets[pair.first.first], vertex_sets[pair.first.second]);
-//        std::cerr << "( " << pair.first.first << " , " << pair.first.second << " ) = " << result[pair.first]
-//                  << std::endl;
-    }
+double OverlapSize::operator()(const base::overlap_count &counts) const {
+    return counts.intersection;
+}
 
-    std::cerr << "Finished calculating scores. " << std::endl;
-    return result;
-}
-
-/*
- * Calculates the score for each pair of sets.
- * The calculation requires the vertices and edges represented by the sets.
- */
-pair_map<double>
-getScores(const vb &vertex_sets,
-          const vusi &edges,
-          std::function<double(base::dynamic_bitset<>, base::dynamic_bitset<>, vusi)> score_function,
-          const pair_map<double> &overlap_sizes) {
-
-    pair_map<double> result;
-    for (const auto &pair : overlap_sizes) {
-        result[pair.first] = score_function(vertex_sets[pair.first.first], vertex_sets[pair.first.second], edges);
-        std::cerr << "( " << pair.first.first << " , " << pair.first.second << " ) = " << result[pair.first]
-                  << std::endl;
-    }
+double OverlapSize::upperBound(std::size_t size1, std::size_t size2) const {
+    return static_cast<double>(std::min(size1, size2));
+}
 
-    return result;
-}
-
-/*
- * Calculates the number of nodes in the interface between the two modules
- */
-double calculate_interface_size_nodes(const base::dynamic_bitset<> &V1,
-                                      const base::dynamic_bitset<> &V2,
-                                      const vusi &E) {
-    std::set<int> interface_nodes;
-    // Count the number of nodes with an edge going to the other set
-    for (int start_node = 0u; start_node < V1.size(); start_node++) {
-        for (int end_node : E[start_node]) {
-            if (V1[start_node] && V2[end_node]) {
-                interface_nodes.insert({start_node, end_node});
-            } else if (V1[start_node] && V2[start_node]) {
-                interface_nodes.insert(start_node);
-            } else if (V1[end_node] && V2[end_node]) {
-                interface_nodes.insert(end_node);
-            }
-        }
-    }
-    return interface_nodes.size();
-}
-
-double calculate_interface_size_edges(const base::dynamic_bitset<> &V1,
-                                      const base::dynamic_bitset<> &V2,
-                                      const vusi &E) {
-    int result = 0;
-
-    for (int start_node = 0u; start_node < V1.size(); start_node++) {
-        if (V1[start_node] || V2[start_node]) {             // Check if the node belongs to any of the two modules
-            for (int end_node : E[start_node]) {
-                if (start_node < end_node) {                // Check all edges only once, not in both directions.
-                    if (V1[start_node] || V2[start_node]) { // Check if the node belongs to any of the two modules
-                        // Check if the nodes are both in the overlap Or if the nodes are in different modules
-                        // Or one node is in the overlap and the other not
-                        if (!((!V1[start_node] && !V1[end_node] && V2[start_node] && V2[end_node]) ||
-                              (V1[start_node] && V1[end_node] && !V2[start_node] && !V2[end_node]))) {
-                            result++;
-                            std::cerr << "( " << start_node << ", " << end_node << ")\n";
-                        }
-                    }
-                }
-            }
-        }
-    }
-    return result;
+double OverlapSize::operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const {
+    return base::count_intersection(set1, set2);
+}
+
+double OverlapSize::operator()(const HybridSet &set1, const HybridSet &set2) const {
+    return countIntersection(set1, set2);
+}
+
+std::size_t getScoreTileSize(const vb &vertex_sets) {
+    if (vertex_sets.empty())
+        return 1;
+    std::size_t set_bytes = std::max<std::size_t>(vertex_sets.front().blocks() * sizeof(base::dynamic_bitset<>::block_type), 1);
+    return std::max<std::size_t>(base::l2_cache_byte_size / (2 * set_bytes), 1);
+}
+
+// The hybrid sets have different sizes, so the tiles use the average
+std::size_t getScoreTileSize(const std::vector<HybridSet> &vertex_sets) {
+    if (vertex_sets.empty())
+        return 1;
+    std::size_t total_bytes = 0;
+    for (const auto &set : vertex_sets)
+        total_bytes += set.getMemoryUsage() + sizeof(HybridSet);
+    std::size_t set_bytes = std::max<std::size_t>(total_bytes / vertex_sets.size(), 1);
+    return std::max<std::size_t>(base::l2_cache_byte_size / (2 * set_bytes), 1);
 }
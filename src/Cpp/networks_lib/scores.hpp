@@ -14,10 +14,15 @@
 #include <bitset>
 #include <unordered_map>
 #include <utility>
+#include <functional>
 
 #include "types.hpp"
 #include "bimap_str_int.hpp"
 #include "overlap_types.hpp"
+#include "hybrid_set.hpp"
+#include "module_sets.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
 
 struct measures_result {
     double min;
@@ -38,33 +43,162 @@ writeMeasures(std::ofstream &report, const measures_result &measures, std::strin
 
 void writeMeasures(std::ofstream &report, const ummss &mapping, std::string_view label1, std::string_view label2);
 
+// The score functions are objects with one call operator per set type, so they can be passed to getScores like a
+// plain function and still work with both bitsets and hybrid sets. They can also score precomputed overlap counts,
+// and bound the score of a pair from the cardinalities alone.
+struct OverlapSize {
+    double operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const;
+
+    double operator()(const HybridSet &set1, const HybridSet &set2) const;
+
+    double operator()(const base::overlap_count &counts) const;
+
+    // Highest score of two sets with these cardinalities: min(|A|, |B|).
+    [[nodiscard]] double upperBound(std::size_t size1, std::size_t size2) const;
+};
+
+struct OverlapSimilarity {
+    double operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const;
+
+    double operator()(const HybridSet &set1, const HybridSet &set2) const;
+
+    double operator()(const base::overlap_count &counts) const;
+
+    // Highest score of two sets with these cardinalities: 1.
+    [[nodiscard]] double upperBound(std::size_t size1, std::size_t size2) const;
+};
+
+// Calculate Jaccard index, which is intersection over union
+struct JaccardSimilarity {
+    double operator()(const base::dynamic_bitset<> &set1, const base::dynamic_bitset<> &set2) const;
+
+    double operator()(const HybridSet &set1, const HybridSet &set2) const;
+
+    double operator()(const base::overlap_count &counts) const;
+
+    // Highest score of two sets with these cardinalities: min(|A|, |B|) / max(|A|, |B|).
+    [[nodiscard]] double upperBound(std::size_t size1, std::size_t size2) const;
+};
+
+inline constexpr OverlapSize getOverlapSize{};
+
+inline constexpr OverlapSimilarity getOverlapSimilarity{};
+
+inline constexpr JaccardSimilarity getJaccardSimilarity{};
+
+// Number of modules per side of the square tiles of the pair matrix, so that the sets of the two module blocks
+// of a tile fit together in the L2 cache.
+std::size_t getScoreTileSize(const vb &vertex_sets);
+
+std::size_t getScoreTileSize(const std::vector<HybridSet> &vertex_sets);
+
+// Scores the pairs of the selected modules. The upper triangle of the pair matrix is split in tiles of tile_size
+// modules per side, which are scored in parallel by num_threads workers (0 uses all hardware threads).
+// score_pair(index1, index2, score) returns false for pairs that should not be stored.
+template<typename R = pair_map<double>, typename P>
+R scoreTiles(const std::vector<int> &selected, std::size_t num_modules, std::size_t tile_size, P score_pair,
+             int num_threads) {
+    const std::size_t num_blocks = (selected.size() + tile_size - 1) / tile_size;
+    std::vector<std::pair<std::size_t, std::size_t>> tiles;
+    for (std::size_t row_block = 0; row_block < num_blocks; row_block++)
+        for (std::size_t column_block = row_block; column_block < num_blocks; column_block++)
+            tiles.emplace_back(row_block, column_block);
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<R> collector(num_modules, num_threads);
+
+    parallelFor(tiles.size(), [&](std::size_t tile, int worker) {
+        const std::size_t row_end = std::min((tiles[tile].first + 1) * tile_size, selected.size());
+        const std::size_t column_end = std::min((tiles[tile].second + 1) * tile_size, selected.size());
+        for (auto row = tiles[tile].first * tile_size; row < row_end; row++) {
+            const auto column_start = std::max(tiles[tile].second * tile_size, row + 1);
+            for (auto column = column_start; column < column_end; column++) {
+                const int index1 = std::min(selected[row], selected[column]);
+                const int index2 = std::max(selected[row], selected[column]);
+                double score;
+                if (score_pair(index1, index2, score) && score > 0)
+                    collector.store(worker, index1, index2, score);
+            }
+        }
+    }, num_threads);
+
+    return collector.finish();
+}
+
 // Calculate score between al pairs of bitsets
 // The sets are the second value of each entry in the sets parameter.
-// The score is a function capable of calculating the overlap with bitsets.
+// The score is a function capable of calculating the overlap with bitsets, called with two const references.
 // Returns only the sets within the module sizes and with a score greater than 0.
-pair_map<double>
-getScores(const vb &vertex_sets, std::function<double(base::dynamic_bitset<>, base::dynamic_bitset<>)> score_function,
-          const int min_module_size, const int max_module_size);
+// Only the modules within the size limits enter the pair loop, using the cached cardinalities.
+// With skip_disjoint, pairs whose non-empty block ranges do not meet are not scored; use it only with scores that
+// are 0 for disjoint sets, like the overlap size.
+// The upper triangle of the pair matrix is split in cache sized tiles, which are scored in parallel by num_threads
+// workers (0 uses all hardware threads).
+// The result is a pair_map by default; pass TriangularPairMap<double> as R when most pairs are expected to score.
+template<typename R = pair_map<double>, typename S>
+R getScores(const ModuleSets &module_sets, S score_function,
+            const int min_module_size, const int max_module_size,
+            bool skip_disjoint = false, int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(module_sets.size(), 1).finish();
+    const std::vector<int> selected = module_sets.select(std::max(min_module_size, 0), max_module_size);
+
+    return scoreTiles<R>(selected, module_sets.size(), getScoreTileSize(module_sets.getSets()),
+                         [&](int index1, int index2, double &score) {
+                             if (skip_disjoint && !module_sets.mayIntersect(index1, index2))
+                                 return false;
+                             score = score_function(module_sets[index1], module_sets[index2]);
+                             return true;
+                         }, num_threads);
+}
+
+// Same as the bitset version, for modules stored as hybrid sets. Each pair is scored with the intersection
+// strategy of its two representations.
+template<typename R = pair_map<double>, typename S>
+R getScores(const std::vector<HybridSet> &vertex_sets, S score_function,
+            const int min_module_size, const int max_module_size, int num_threads = 0) {
+
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return PairCollector<R>(vertex_sets.size(), 1).finish();
+    std::vector<int> selected;
+    for (std::size_t I = 0; I < vertex_sets.size(); I++) {
+        const auto size = vertex_sets[I].count();
+        if (static_cast<std::size_t>(std::max(min_module_size, 0)) <= size
+            && size <= static_cast<std::size_t>(max_module_size))
+            selected.push_back(static_cast<int>(I));
+    }
+    std::stable_sort(selected.begin(), selected.end(), [&](int index1, int index2) {
+        return vertex_sets[index1].count() < vertex_sets[index2].count();
+    });
+
+    return scoreTiles<R>(selected, vertex_sets.size(), getScoreTileSize(vertex_sets),
+                         [&](int index1, int index2, double &score) {
+                             score = score_function(vertex_sets[index1], vertex_sets[index2]);
+                             return true;
+                         }, num_threads);
+}
+
+template<typename R = pair_map<double>, typename S>
+R getScores(const vb &vertex_sets, S score_function,
+            const int min_module_size, const int max_module_size, int num_threads = 0) {
+    return getScores<R>(ModuleSets(vertex_sets), score_function, min_module_size, max_module_size, false, num_threads);
+}
 
 // Calculate score between the selected pairs.
 // The sets are the second value of each entry in the sets parameter.
-// The score is a function capable of calculating the overlap with bitsets.
-pair_map<double>
-getScores(const vb &vertex_sets, std::function<double(base::dynamic_bitset<>, base::dynamic_bitset<>)> score_function,
-          const pair_map<double> &prev_score);
-
-pair_map<double>
-getScores(const vb &vertex_sets,
-          const vusi &edges,
-          std::function<double(base::dynamic_bitset<>, base::dynamic_bitset<>, vusi)> score_function,
-          const pair_map<double> &prev_score);
-
-double calculate_interface_size_nodes(const base::dynamic_bitset<> &V1,
-                                      const base::dynamic_bitset<> &V2,
-                                      const vusi &E);
-
-double calculate_interface_size_edges(const base::dynamic_bitset<> &V1,
-                                      const base::dynamic_bitset<> &V2,
-                                      const vusi &E);
+// The score is a function capable of calculating the overlap with bitsets, called with two const references.
+template<typename S>
+pair_map<double> getScores(const vb &vertex_sets, S score_function, const pair_map<double> &prev_scores) {
+
+    pair_map<double> result;
+    for (const auto &pair : prev_scores) {
+        result[pair.first] = score_function(vertex_sets[pair.first.first], vertex_sets[pair.first.second]);
+    }
+
+    std::cerr << "Finished calculating scores. " << std::endl;
+    return result;
+}
 
 #endif /* UTILITY_HPP_ */
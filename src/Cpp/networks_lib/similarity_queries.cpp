@@ -0,0 +1,121 @@
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include "similarity_queries.hpp"
+
+namespace {
+
+    // Number of entities of a set of the size that must contain a shared entity with any set of Jaccard >= threshold
+    std::size_t prefixLength(std::size_t size, double threshold) {
+        const auto required = static_cast<std::size_t>(std::ceil(threshold * size - 1e-9));
+        return size - std::min(required, size) + 1;
+    }
+}
+
+pair_map<double> getJaccardPairs(const EntityIndex &index, double threshold,
+                                 const int min_module_size, const int max_module_size, int num_threads) {
+
+    if (!(threshold > 0 && threshold <= 1))
+        throw std::invalid_argument("The Jaccard threshold must be in (0, 1], got " + std::to_string(threshold));
+    if (max_module_size < 0 || max_module_size < min_module_size)
+        return {};
+    std::vector<int> selected = index.select(std::max(min_module_size, 1), max_module_size);
+
+    // Entities ranked from the least frequent among the selected modules
+    std::vector<int> frequencies(index.numEntities(), 0);
+    for (int module : selected)
+        for (int entity : index.getEntities(module))
+            frequencies[entity]++;
+    std::vector<int> entities(index.numEntities());
+    std::iota(entities.begin(), entities.end(), 0);
+    std::stable_sort(entities.begin(), entities.end(), [&](int entity1, int entity2) {
+        return frequencies[entity1] < frequencies[entity2];
+    });
+    std::vector<int> ranks(index.numEntities());
+    for (std::size_t rank = 0; rank < entities.size(); rank++)
+        ranks[entities[rank]] = static_cast<int>(rank);
+
+    // Ranked entities of every selected module, and the modules that have each rank in their prefix
+    std::vector<int> order(index.numModules(), -1);      // Position of the module sorted by size, then by index
+    std::stable_sort(selected.begin(), selected.end(), [&](int module1, int module2) {
+        return index.cardinality(module1) < index.cardinality(module2);
+    });
+    std::vector<std::size_t> ranked_offsets(index.numModules() + 1, 0);
+    for (std::size_t position = 0; position < selected.size(); position++) {
+        order[selected[position]] = static_cast<int>(position);
+        ranked_offsets[selected[position] + 1] = index.cardinality(selected[position]);
+    }
+    std::partial_sum(ranked_offsets.begin(), ranked_offsets.end(), ranked_offsets.begin());
+    std::vector<int> ranked(ranked_offsets.back());
+    std::vector<int> prefix_offsets(index.numEntities() + 1, 0);
+    for (int module : selected) {
+        auto begin = ranked.begin() + ranked_offsets[module];
+        std::size_t position = ranked_offsets[module];
+        for (int entity : index.getEntities(module))
+            ranked[position++] = ranks[entity];
+        std::sort(begin, ranked.begin() + ranked_offsets[module + 1]);
+        for (std::size_t I = 0; I < prefixLength(index.cardinality(module), threshold); I++)
+            prefix_offsets[begin[I] + 1]++;
+    }
+    std::partial_sum(prefix_offsets.begin(), prefix_offsets.end(), prefix_offsets.begin());
+    std::vector<int> prefix_modules(prefix_offsets.back());
+    {
+        std::vector<int> positions(prefix_offsets.begin(), prefix_offsets.end() - 1);
+        for (int module : selected)
+            for (std::size_t I = 0; I < prefixLength(index.cardinality(module), threshold); I++)
+                prefix_modules[positions[ranked[ranked_offsets[module] + I]]++] = module;
+    }
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    PairCollector<pair_map<double>> collector(index.numModules(), num_threads);
+    std::vector<std::vector<char>> seen(num_threads);
+    std::vector<std::vector<int>> candidates(num_threads);
+
+    // Each pair is found from the module that goes later in the order by size
+    parallelFor(selected.size(), [&](std::size_t task, int worker) {
+        const int module1 = selected[task];
+        const std::size_t size1 = index.cardinality(module1);
+        auto &is_seen = seen[worker];
+        auto &module_candidates = candidates[worker];
+        if (is_seen.empty())
+            is_seen.assign(index.numModules(), false);
+
+        const int *ranked1 = ranked.data() + ranked_offsets[module1];
+        for (std::size_t I = 0; I < prefixLength(size1, threshold); I++) {
+            const int rank = ranked1[I];
+            for (int position = prefix_offsets[rank]; position < prefix_offsets[rank + 1]; position++) {
+                const int module2 = prefix_modules[position];
+                if (order[module2] >= order[module1] || is_seen[module2]
+                    || static_cast<double>(index.cardinality(module2)) < threshold * size1 - 1e-9)
+                    continue;
+                is_seen[module2] = true;
+                module_candidates.push_back(module2);
+            }
+        }
+
+        for (int module2 : module_candidates) {
+            is_seen[module2] = false;
+            const std::size_t size2 = index.cardinality(module2);
+            const int *ranked2 = ranked.data() + ranked_offsets[module2];
+            std::size_t intersection = 0, position1 = 0, position2 = 0;
+            while (position1 < size1 && position2 < size2) {
+                if (ranked1[position1] < ranked2[position2]) {
+                    position1++;
+                } else if (ranked2[position2] < ranked1[position1]) {
+                    position2++;
+                } else {
+                    intersection++;
+                    position1++;
+                    position2++;
+                }
+            }
+            const double jaccard = static_cast<double>(intersection) / (size1 + size2 - intersection);
+            if (jaccard >= threshold)
+                collector.store(worker, std::min(module1, module2), std::max(module1, module2), jaccard);
+        }
+        module_candidates.clear();
+    }, num_threads);
+
+    return collector.finish();
+}
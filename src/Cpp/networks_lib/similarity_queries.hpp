@@ -0,0 +1,94 @@
+#ifndef PROTEOFORMNETWORKS_SIMILARITY_QUERIES_HPP
+#define PROTEOFORMNETWORKS_SIMILARITY_QUERIES_HPP
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "entity_index.hpp"
+#include "overlap_types.hpp"
+#include "pair_collector.hpp"
+#include "parallel.hpp"
+
+// Queries that return only the best scoring pairs of modules, instead of every pair with a score greater than 0.
+
+// Partners of a module with their scores, sorted by decreasing score, then by partner index.
+using partner_list = std::vector<std::pair<int, double>>;
+
+// For every module, the k partners with the highest scores among the modules within the sizes. Modules outside the
+// sizes get an empty list.
+// The candidates of each module are the modules sharing an entity with it, found walking the postings, so pairs
+// with nothing in common are never partners. When the score has an upperBound from the cardinalities, a candidate
+// that can not beat the current k-th partner is not scored.
+template<typename S>
+std::vector<partner_list> getTopPartners(const EntityIndex &index, S score_function, std::size_t k,
+                                         const int min_module_size, const int max_module_size,
+                                         int num_threads = 0) {
+
+    std::vector<partner_list> result(index.numModules());
+    if (k == 0 || max_module_size < 0 || max_module_size < min_module_size)
+        return result;
+    const std::vector<int> selected = index.select(std::max(min_module_size, 0), max_module_size);
+    std::vector<char> is_selected(index.numModules(), false);
+    for (int module : selected)
+        is_selected[module] = true;
+
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    std::vector<std::vector<int>> shared_counts(num_threads);
+    std::vector<std::vector<int>> touched_modules(num_threads);
+
+    // Worse partners go first, so the front of the heap is the k-th best
+    auto better = [](const std::pair<int, double> &partner1, const std::pair<int, double> &partner2) {
+        return partner1.second > partner2.second
+               || (partner1.second == partner2.second && partner1.first < partner2.first);
+    };
+
+    parallelFor(selected.size(), [&](std::size_t task, int worker) {
+        const int module1 = selected[task];
+        auto &shared = shared_counts[worker];
+        auto &touched = touched_modules[worker];
+        if (shared.empty())
+            shared.assign(index.numModules(), 0);
+
+        for (int entity : index.getEntities(module1))
+            for (int module2 : index.getModules(entity))
+                if (module2 != module1 && is_selected[module2] && shared[module2]++ == 0)
+                    touched.push_back(module2);
+
+        auto &partners = result[module1];
+        for (int module2 : touched) {
+            const std::size_t size1 = index.cardinality(module1), size2 = index.cardinality(module2);
+            bool may_enter = true;
+            if constexpr (requires { score_function.upperBound(size1, size2); }) {
+                may_enter = partners.size() < k || score_function.upperBound(size1, size2) >= partners.front().second;
+            }
+            if (may_enter) {
+                const std::pair<int, double> partner(module2, score_function(
+                        base::overlap_count{size1, size2, static_cast<std::size_t>(shared[module2])}));
+                if (partner.second > 0 && (partners.size() < k || better(partner, partners.front()))) {
+                    if (partners.size() == k) {
+                        std::pop_heap(partners.begin(), partners.end(), better);
+                        partners.pop_back();
+                    }
+                    partners.push_back(partner);
+                    std::push_heap(partners.begin(), partners.end(), better);
+                }
+            }
+            shared[module2] = 0;
+        }
+        touched.clear();
+        std::sort_heap(partners.begin(), partners.end(), better);
+    }, num_threads);
+
+    return result;
+}
+
+// Pairs of modules within the sizes whose Jaccard index is at least the threshold, which must be in (0, 1].
+// Throws std::invalid_argument for other thresholds. Empty modules are never paired.
+// Uses the length filter (J(A, B) >= t needs t|A| <= |B| <= |A| / t) and prefix filtering: with the entities of
+// every module sorted from the rarest, two modules reaching the threshold share an entity among the first
+// |A| - ceil(t|A|) + 1 of each. Only the pairs that meet in the prefixes have their intersection counted.
+pair_map<double> getJaccardPairs(const EntityIndex &index, double threshold,
+                                 const int min_module_size, const int max_module_size, int num_threads = 0);
+
+#endif //PROTEOFORMNETWORKS_SIMILARITY_QUERIES_HPP
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <utility>
+#include "parallel.hpp"
+#include "string_sort.hpp"
+
+namespace {
+
+    constexpr std::size_t INSERTION_SORT_LIMIT = 16;
+    constexpr std::size_t MIN_RUN_SIZE = std::size_t(1) << 14;
+
+    // Character at the depth, or -1 past the end so shorter strings go first
+    inline int characterAt(std::string_view s, std::size_t depth) {
+        return depth < s.size() ? static_cast<unsigned char>(s[depth]) : -1;
+    }
+
+    // The strings share their first depth characters
+    void insertionSort(std::string_view *begin, std::string_view *end, std::size_t depth) {
+        for (auto current = begin + 1; current < end; current++) {
+            std::string_view value = *current;
+            auto position = current;
+            while (position > begin && value.substr(depth) < position[-1].substr(depth)) {
+                *position = position[-1];
+                position--;
+            }
+            *position = value;
+        }
+    }
+
+    // The strings share their first depth characters
+    void multikeyQuicksort(std::string_view *begin, std::string_view *end, std::size_t depth) {
+        while (static_cast<std::size_t>(end - begin) > INSERTION_SORT_LIMIT) {
+            const std::size_t size = end - begin;
+            int a = characterAt(begin[0], depth), b = characterAt(begin[size / 2], depth);
+            int c = characterAt(begin[size - 1], depth);
+            const int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));     // Median of three
+
+            // Partition in [begin, less) < pivot, [less, greater) == pivot, [greater, end) > pivot
+            std::string_view *less = begin, *current = begin, *greater = end;
+            while (current < greater) {
+                const int character = characterAt(*current, depth);
+                if (character < pivot)
+                    std::swap(*less++, *current++);
+                else if (character > pivot)
+                    std::swap(*current, *--greater);
+                else
+                    current++;
+            }
+
+            multikeyQuicksort(begin, less, depth);
+            multikeyQuicksort(greater, end, depth);
+            if (pivot < 0)      // All the strings in the middle ended and are equal
+                return;
+            begin = less;
+            end = greater;
+            depth++;
+        }
+        insertionSort(begin, end, depth);
+    }
+}
+
+void sortUnique(std::vector<std::string_view> &strings, int num_threads) {
+    if (num_threads <= 0)
+        num_threads = defaultNumThreads();
+    const std::size_t num_runs = std::max<std::size_t>(1, std::min<std::size_t>(num_threads,
+                                                                                strings.size() / MIN_RUN_SIZE));
+
+    // Each run keeps its unique strings at the front of its range
+    std::vector<std::size_t> run_begins(num_runs + 1), run_ends(num_runs);
+    for (std::size_t run = 0; run <= num_runs; run++)
+        run_begins[run] = strings.size() * run / num_runs;
+
+    parallelFor(num_runs, [&](std::size_t run, int) {
+        auto begin = strings.data() + run_begins[run], end = strings.data() + run_begins[run + 1];
+        multikeyQuicksort(begin, end, 0);
+        run_ends[run] = std::unique(begin, end) - strings.data();
+    }, num_threads);
+
+    // Merges the runs in pairs. The merged run is compacted to the front of the range of the pair.
+    for (std::size_t width = 1; width < num_runs; width *= 2) {
+        const std::size_t num_pairs = (num_runs + 2 * width - 1) / (2 * width);
+        parallelFor(num_pairs, [&](std::size_t pair, int) {
+            const std::size_t left = pair * 2 * width, right = left + width;
+            if (right >= num_runs)
+                return;
+            const auto begin = strings.begin() + run_begins[left];
+            const auto right_begin = strings.begin() + run_begins[right];
+            auto left_end = strings.begin() + run_ends[left];
+            auto right_end = std::move(right_begin, strings.begin() + run_ends[right], left_end);
+            std::inplace_merge(begin, left_end, right_end);
+            run_ends[left] = std::unique(begin, right_end) - strings.begin();
+        }, num_threads);
+    }
+
+    strings.resize(run_ends[0]);
+}
@@ -0,0 +1,13 @@
+#ifndef PROTEOFORMNETWORKS_STRING_SORT_HPP
+#define PROTEOFORMNETWORKS_STRING_SORT_HPP
+
+#include <string_view>
+#include <vector>
+
+// Sorts the strings lexicographically and removes the repeated ones, in place.
+// The strings are split in one run per task; each run is sorted with multikey quicksort (three way radix quicksort,
+// which compares each character once per partitioning level instead of comparing whole strings) and deduplicated,
+// then the runs are merged in pairs, in parallel, until one is left.
+void sortUnique(std::vector<std::string_view> &strings, int num_threads = 0);
+
+#endif //PROTEOFORMNETWORKS_STRING_SORT_HPP
@@ -39,7 +39,7 @@ namespace gene_level_only_overlap {
 		bitset<size_proteoforms> result;
 		for (int I = 0; I < proteoform_set.size(); I++) {
 			if (proteoform_set.test(I)) {
-				if (accessions.find(proteoform::getAccession(proteoforms.int_to_str.at(I))) != accessions.end()) {
+				if (accessions.find(string(proteoform::parseProteoform(proteoforms.int_to_str.at(I)).accession)) != accessions.end()) {
 					result.set(I);
 				}
 			}
@@ -69,11 +69,12 @@ namespace modified_overlap {
 	Frequencies getFrequencies(const map<pair<string, string>, bitset<total_proteoforms>>& proteoform_overlap_pairs,
 		const bimap_str_int& proteoforms) {
 		Frequencies frequencies;
+		const proteoform::ProteoformTable parsed_proteoforms(proteoforms.int_to_str);   // Parse each proteoform once
 		for (const auto& overlap_pair : proteoform_overlap_pairs) {
 			// For each overlap set
 			for (int I = 0; I < overlap_pair.second.size(); I++) {
 				if (overlap_pair.second.test(I)) {
-					string accession = proteoform::getAccession(proteoforms.int_to_str[I]);
+					string accession(parsed_proteoforms.getAccession(I));
 					if (frequencies.proteins.find(accession) == frequencies.proteins.end()) {
 						frequencies.proteins.emplace(accession, 0);
 					}
@@ -84,11 +85,8 @@ namespace modified_overlap {
 					}
 					frequencies.proteoforms[proteoforms.int_to_str[I]]++;
 
-					for (const auto& modification : proteoform::getModifications(proteoforms.int_to_str[I])) {
-						if (frequencies.modifications.find(modification) == frequencies.modifications.end()) {
-							frequencies.modifications[modification] = 0;
-						}
-						frequencies.modifications[modification]++;
+					for (const auto& modification : parsed_proteoforms.getModifications(I)) {
+						frequencies.modifications[string(modification.mod)]++;
 					}
 				}
 			}
@@ -18,13 +18,6 @@
 
 int countSharedVertices(Module m1, Module m2, Interactome interactome);
 
-double getOverlapSize(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2);
-
-double getOverlapSimilarity(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2);
-
-// Calculate Jaccard index, which is intersection over union
-double getJaccardSimilarity(base::dynamic_bitset<> set1, base::dynamic_bitset<> set2);
-
 void calculateOverlap(Interactome interactome, std::vector<std::map<std::string, Module>> modules,
                       const std::string &output_path);
 